@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/Configuration.h>
+
+#include "benchmark/benchmark.h"
+
+/** Similar to the requests handled by mc_control::ControllerServer */
+static const char * request = R"({
+  "category": ["Tasks", "CoM"],
+  "name": "target",
+  "data": {"target": [0.0, 0.1, 0.8], "weight": 1000, "stiffness": 5.0, "active": true}
+})";
+
+/** Report the allocations per iteration when the allocation hooks are loaded (see mc_rtc/AllocationTracker.h) */
+static void reportAllocations(benchmark::State & state)
+{
+  if(mc_rtc::alloc::available())
+  {
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(mc_rtc::alloc::allocations()),
+                                                       benchmark::Counter::kAvgIterations);
+  }
+}
+
+static void BM_ConfigurationFromData(benchmark::State & state)
+{
+  mc_rtc::alloc::reset();
+  while(state.KeepRunning())
+  {
+    mc_rtc::alloc::Scope scope("fromData");
+    auto config = mc_rtc::Configuration::fromData(request);
+    auto category = config("category", std::vector<std::string>{});
+    auto name = config("name", std::string{});
+    auto data = config("data", mc_rtc::Configuration{});
+    Eigen::Vector3d target = data("target");
+    benchmark::DoNotOptimize(target);
+  }
+  reportAllocations(state);
+}
+BENCHMARK(BM_ConfigurationFromData);
+
+/** Same as BM_ConfigurationFromData through a scratch document, as in ControllerServer::handle_requests */
+static void BM_ConfigurationScratchData(benchmark::State & state)
+{
+  mc_rtc::alloc::reset();
+  while(state.KeepRunning())
+  {
+    mc_rtc::alloc::Scope scope("ScratchData");
+    mc_rtc::Configuration::ScratchData scratch(request);
+    std::vector<std::string> category;
+    scratch.read("category", category);
+    std::string name;
+    scratch.read("name", name);
+    auto data = scratch.copy("data");
+    Eigen::Vector3d target = data("target");
+    benchmark::DoNotOptimize(target);
+  }
+  reportAllocations(state);
+}
+BENCHMARK(BM_ConfigurationScratchData);
+
+static void BM_ConfigurationBuild(benchmark::State & state)
+{
+  while(state.KeepRunning())
+  {
+    mc_rtc::Configuration config;
+    for(int i = 0; i < state.range(0); ++i)
+    {
+      auto entry = config.add(std::to_string(i));
+      entry.add("name", "entry");
+      entry.add("weight", 1000.0);
+      entry.add("target", Eigen::Vector3d{0.0, 0.1, 0.8});
+    }
+    benchmark::DoNotOptimize(config.size());
+  }
+}
+BENCHMARK(BM_ConfigurationBuild)->Arg(10)->Arg(100)->Arg(1000);
+
+/** A long-lived document whose values are overwritten repeatedly */
+static void BM_ConfigurationOverwrite(benchmark::State & state)
+{
+  mc_rtc::Configuration config;
+  while(state.KeepRunning())
+  {
+    config.add("name", "a string that does not fit in a short string");
+    config.add("target", Eigen::Vector3d{0.0, 0.1, 0.8});
+  }
+}
+BENCHMARK(BM_ConfigurationOverwrite);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/Robots.h>
+#include <mc_rtc/pragma.h>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark/benchmark.h"
+
+/** Frame position computed by walking the parent chain every time (implementation before caching) */
+static sva::PTransformd recursivePosition(const mc_rbdyn::RobotFrame & frame)
+{
+  if(!frame.parent())
+  {
+    return frame.X_p_f() * frame.robot().mbc().bodyPosW[frame.bodyMbcIndex()];
+  }
+  return frame.X_p_f() * recursivePosition(static_cast<const mc_rbdyn::RobotFrame &>(*frame.parent()));
+}
+
+class RobotFramesFixture : public benchmark::Fixture
+{
+public:
+  void SetUp(const ::benchmark::State &)
+  {
+    MC_RTC_diagnostic_push
+    MC_RTC_diagnostic_ignored(GCC, "-Wunused-variable")
+    static bool initialized = []() {
+      spdlog::set_level(spdlog::level::err);
+      mc_rbdyn::RobotLoader::clear();
+      mc_rtc::Loader::debug_suffix = "";
+      mc_rbdyn::RobotLoader::update_robot_module_path({"@CMAKE_CURRENT_BINARY_DIR@/../src/mc_robots"});
+      return true;
+    }();
+    MC_RTC_diagnostic_pop
+    auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+    robots = mc_rbdyn::loadRobot(*rm);
+    auto & robot = robots->robot();
+    // Chains of 10 frames on every body in addition to the robot's own frames
+    for(const auto & b : robot.mb().bodies())
+    {
+      auto * parent = &robot.frame(b.name());
+      for(size_t i = 0; i < 10; ++i)
+      {
+        parent = &robot.makeFrame(fmt::format("{}_{}", b.name(), i), *parent,
+                                  sva::PTransformd(Eigen::Vector3d(0.01, 0.0, 0.0)));
+      }
+    }
+    for(const auto & f : robot.frames())
+    {
+      frames.push_back(&robot.frame(f));
+    }
+  }
+
+  void TearDown(const ::benchmark::State &)
+  {
+    frames.clear();
+    robots.reset();
+  }
+
+  mc_rbdyn::RobotsPtr robots;
+  std::vector<const mc_rbdyn::RobotFrame *> frames;
+};
+
+/** Every frame is evaluated 3 times per iteration to mimic several consumers (tasks, criteria, GUI) */
+BENCHMARK_DEFINE_F(RobotFramesFixture, Recursive)(benchmark::State & state)
+{
+  auto & robot = robots->robot();
+  while(state.KeepRunning())
+  {
+    robot.forwardKinematics();
+    for(size_t i = 0; i < 3; ++i)
+    {
+      for(const auto * f : frames)
+      {
+        benchmark::DoNotOptimize(recursivePosition(*f));
+      }
+    }
+  }
+}
+BENCHMARK_REGISTER_F(RobotFramesFixture, Recursive)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_DEFINE_F(RobotFramesFixture, Cached)(benchmark::State & state)
+{
+  auto & robot = robots->robot();
+  while(state.KeepRunning())
+  {
+    robot.forwardKinematics();
+    for(size_t i = 0; i < 3; ++i)
+    {
+      for(const auto * f : frames)
+      {
+        benchmark::DoNotOptimize(f->position());
+      }
+    }
+  }
+}
+BENCHMARK_REGISTER_F(RobotFramesFixture, Cached)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_DEFINE_F(RobotFramesFixture, CachedVelocity)(benchmark::State & state)
+{
+  auto & robot = robots->robot();
+  while(state.KeepRunning())
+  {
+    robot.forwardKinematics();
+    robot.forwardVelocity();
+    for(size_t i = 0; i < 3; ++i)
+    {
+      for(const auto * f : frames)
+      {
+        benchmark::DoNotOptimize(f->velocity());
+      }
+    }
+  }
+}
+BENCHMARK_REGISTER_F(RobotFramesFixture, CachedVelocity)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -13,6 +13,7 @@
 
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace mc_control
@@ -812,6 +813,11 @@ protected:
   /* Hold data from the server */
   mc_rtc::Configuration data_;
 
+  /* Elements of the last full state, partial states are applied to it */
+  mc_rtc::Configuration full_state_;
+  /* Identifier of the last full state, 0 if the server does not send partial states */
+  uint64_t full_state_id_ = 0;
+
   /* Pointer to the server if connected in-memory */
   ControllerServer * server_ = nullptr;
   /* Pointer to the GUI if connected in-memory */
@@ -821,6 +827,16 @@ private:
   /** Default implementations for widgets' creations display a warning message to the user */
   virtual void default_impl(const std::string & type, const ElementId & id);
 
+  /** Handle a category where the elements listed in \p changes replace the ones in \p data
+   *
+   * \param idx Index of the next element in a depth-first traversal of the GUI
+   */
+  void handle_category(const std::vector<std::string> & parent,
+                       const std::string & category,
+                       const mc_rtc::Configuration & data,
+                       const std::unordered_map<size_t, mc_rtc::Configuration> & changes,
+                       size_t & idx);
+
   /** Handle details of Point3D elements */
   void handle_point3d(const ElementId & id, const mc_rtc::Configuration & data);
 
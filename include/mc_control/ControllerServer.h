@@ -8,7 +8,10 @@
 
 #include <mc_rtc/gui/StateBuilder.h>
 
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace mc_control
@@ -51,18 +54,82 @@ struct MC_CONTROL_DLLAPI ControllerServer
   /** Publish the current GUI state */
   void publish(mc_rtc::gui::StateBuilder & gui_builder);
 
-  /** Get latest published data */
+  /** Only publish the GUI elements that changed since the last full state
+   *
+   * See mc_rtc::gui::StateBuilder::updateDelta for details
+   *
+   * \param enable If true, publish partial states
+   *
+   * \param snapshot_period Period between two full states (in seconds), clients that join or miss a full state can
+   * only resume on the next full state
+   */
+  void delta(bool enable, double snapshot_period = 1.0);
+
+  /** Build and send the GUI messages in a separate thread
+   *
+   * When enabled, \ref publish only captures the GUI state in a snapshot (see mc_rtc::gui::StateBuilder::capture)
+   * and hands it over to the server thread which builds and sends the message. The calling thread never waits for
+   * the server thread: if the previous snapshot has not been sent yet it is replaced by the new one.
+   *
+   * \param enable If true, publish from a separate thread
+   */
+  void async(bool enable);
+
+  /** Get latest published data
+   *
+   * The size is zero if nothing was published by the last call to \ref publish. When the messages are published
+   * asynchronously, this is the latest message sent by the server thread before the last call to \ref publish.
+   */
   std::pair<const char *, size_t> data() const;
 
 private:
   unsigned int iter_;
   unsigned int rate_;
+  double dt_;
+
+  /** Partial states publication */
+  bool delta_ = false;
+  /** Number of publications between two full states */
+  unsigned int snapshot_rate_ = 1;
+  /** Number of publications since the last full state */
+  unsigned int snapshot_iter_ = 0;
 
   int pub_socket_;
   int pull_socket_;
 
   std::vector<char> buffer_;
   size_t buffer_size_ = 0;
+
+  /** Asynchronous publication */
+  bool async_ = false;
+  /** Snapshot updated by publish */
+  mc_rtc::gui::StateBuilder::Snapshot capture_;
+  /** Snapshot waiting to be sent */
+  mc_rtc::gui::StateBuilder::Snapshot pending_;
+  /** Snapshot being sent by the server thread */
+  mc_rtc::gui::StateBuilder::Snapshot sending_;
+  /** Builds the message from sending_ */
+  mc_rtc::gui::StateBuilder::Encoder encoder_;
+  /** Message built by the server thread */
+  std::vector<char> async_buffer_;
+  size_t async_buffer_size_ = 0;
+  /** Last message sent by the server thread, exchanged with buffer_ by publish */
+  std::vector<char> published_;
+  size_t published_size_ = 0;
+  /** True if published_ holds a message that was not exchanged yet */
+  bool has_published_ = false;
+  /** True if pending_ holds a snapshot that was not sent yet */
+  bool has_pending_ = false;
+  /** True if pending_ should be sent as a full state */
+  bool pending_full_ = false;
+  /** False when the server thread should stop */
+  bool running_ = false;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+
+  /** Server thread loop */
+  void run();
 };
 
 } // namespace mc_control
@@ -39,6 +39,19 @@ struct MC_CONTROL_DLLAPI GlobalPlugin
     /** True if this plugin should run regardless of the gc.running status, if false, this plugin only runs when
      * gc.running is true */
     bool should_always_run = true;
+    /** True if this plugin only reads the controller state after the global controller run
+     *
+     * Instead of \ref after, \ref capture is called on the control thread and \ref process is called on a dedicated
+     * thread where it overlaps with the next iterations of the global controller. \ref before is still called on the
+     * control thread if \ref should_run_before is true.
+     */
+    bool async = false;
+    /** Time budget (in seconds) of \ref process for asynchronous plugins, zero means one controller timestep
+     *
+     * Processing that exceeds this budget is reported as an overrun. If the previous \ref process call has not
+     * finished when the next capture is due, the capture is skipped for this iteration and this is reported as well.
+     */
+    double async_deadline = 0;
   };
 
   /** Returns the plugin running configuration
@@ -90,6 +103,22 @@ struct MC_CONTROL_DLLAPI GlobalPlugin
    *
    */
   virtual void after(mc_control::MCGlobalController & controller) = 0;
+
+  /** Copy the data needed by \ref process, called on the control thread instead of \ref after for asynchronous
+   * plugins
+   *
+   * This is never called while \ref process is running so the captured data does not need to be protected
+   *
+   * \param controller MCGlobalController instance that owns this plugin
+   *
+   */
+  virtual void capture(mc_control::MCGlobalController &) {}
+
+  /** Process the data copied by \ref capture, called on a dedicated thread for asynchronous plugins
+   *
+   * The controller state must not be accessed from this function
+   */
+  virtual void process() {}
 };
 
 } // namespace mc_control
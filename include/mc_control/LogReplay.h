@@ -0,0 +1,87 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_control/mc_global_controller.h>
+
+#include <map>
+#include <string>
+
+namespace mc_control
+{
+
+/** Options of \ref replayLog */
+struct MC_CONTROL_DLLAPI LogReplayOptions
+{
+  /** Number of ticks excluded from the timing statistics */
+  size_t warmup = 100;
+  /** Maximum number of ticks to replay, 0 replays the whole log */
+  size_t max_ticks = 0;
+  /** Outputs that differ from the log by more than this are reported as divergences */
+  double tolerance = 1e-6;
+};
+
+/** Result of \ref replayLog */
+struct MC_CONTROL_DLLAPI LogReplayReport
+{
+  /** Replayed log */
+  std::string log;
+  /** Controller that ran */
+  std::string controller;
+  /** True if the log was read and every call to MCGlobalController::run succeeded */
+  bool success = false;
+  /** Number of replayed ticks (including the warm-up) */
+  size_t ticks = 0;
+  /** Number of warm-up ticks */
+  size_t warmup = 0;
+  /** Controller timestep (s) */
+  double timestep = 0;
+  /** Time spent in MCGlobalController::run after the warm-up (s) */
+  double run_time = 0;
+  /** Replayed time over run_time */
+  double realtime_factor = 0;
+  /** Latency statistics of MCGlobalController after the warm-up (ms), see MCGlobalController::latencyStatistics */
+  mc_rtc::Configuration latency;
+  /** Tolerance used to detect divergences */
+  double tolerance = 0;
+  /** Number of ticks where an output diverged from the log */
+  size_t diverged_ticks = 0;
+  /** First tick where an output diverged from the log, -1 if none did */
+  int64_t first_divergence = -1;
+  /** Largest absolute difference between the replayed outputs and the log, per log entry */
+  std::map<std::string, double> max_error;
+
+  /** True if the replayed outputs match the log */
+  inline bool deterministic() const noexcept
+  {
+    return diverged_ticks == 0;
+  }
+
+  /** Machine-readable report */
+  mc_rtc::Configuration save() const;
+};
+
+/** Replay the sensor inputs recorded in a binary log through a controller as fast as possible
+ *
+ * The inputs of the main robot are read from the standard log entries written by MCController: encoders (qIn,
+ * alphaIn), joint torques (tauIn), force sensors (by name) and body sensors ([name]_position, [name]_orientation, ...).
+ * The controller is initialized from the first record: encoders from qIn and attitude from ff.
+ *
+ * Every tick, the outputs of the main robot (qOut, alphaOut, tauOut and ff) are compared against the log. The replay
+ * is deterministic when the controller and its configuration match the ones that produced the log.
+ *
+ * Only the time spent in MCGlobalController::run is measured, the log is read in between.
+ *
+ * \param controller Controller to run, it must not be initialized yet
+ *
+ * \param log Path to the binary log
+ *
+ * \param options Replay options
+ */
+MC_CONTROL_DLLAPI LogReplayReport replayLog(MCGlobalController & controller,
+                                            const std::string & log,
+                                            const LogReplayOptions & options = {});
+
+} // namespace mc_control
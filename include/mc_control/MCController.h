@@ -720,6 +720,16 @@ protected:
                               mc_rbdyn::Robots & robots,
                               const mc_rbdyn::LoadRobotParameters & params);
 
+  /** Load an additional robot into the controller from a shared module
+   *
+   * The module is not copied, \see mc_rbdyn::Robots::load(const std::string &, mc_rbdyn::ConstRobotModulePtr, const
+   * mc_rbdyn::LoadRobotParameters &)
+   */
+  mc_rbdyn::Robot & loadRobot(mc_rbdyn::ConstRobotModulePtr rm,
+                              const std::string & name,
+                              mc_rbdyn::Robots & robots,
+                              const mc_rbdyn::LoadRobotParameters & params);
+
   /** Add a control robot to the log */
   void addRobotToLog(const mc_rbdyn::Robot & robot);
 
@@ -10,7 +10,12 @@
 #include <mc_control/fsm/TransitionMap.h>
 
 #include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 
 namespace mc_control
 {
@@ -43,6 +48,9 @@ struct MC_CONTROL_FSM_DLLAPI Executor
   Executor & operator=(const Executor &) = delete;
   Executor & operator=(Executor &&) = delete;
 
+  /** Stop the background creation of states (see Prebuild), this waits for the state being created if any */
+  ~Executor();
+
   /** Initialize the executor
    *
    * \param ctl Controller using this executor
@@ -158,6 +166,8 @@ private:
   bool managed_ = false;
   /** If true and not managed, waits for trigger before transitions */
   bool step_by_step_ = true;
+  /** If true and not managed, the states that may follow the current state are created in the background */
+  bool prebuild_ = false;
 
   /** Transition map, empty if managed */
   TransitionMap transition_map_;
@@ -186,6 +196,23 @@ private:
   duration_ms state_run_dt_{0};
   /** Monitor state's teardown performance */
   duration_ms state_teardown_dt_{0};
+  /** States created and configured in the background but not started yet */
+  std::unordered_map<std::string, StatePtr> prebuilt_;
+  /** Background thread creating and destroying the states, started by the first call to prebuild */
+  std::thread prebuild_thread_;
+  /** Protects the following members which are shared with the background thread */
+  std::mutex prebuild_mutex_;
+  std::condition_variable prebuild_cv_;
+  /** If true, the background thread destroys the pending states and exits */
+  bool prebuild_stop_ = false;
+  /** States (and their configuration) to create in the background, replaced by each transition */
+  std::vector<std::pair<std::string, std::optional<mc_rtc::Configuration>>> prebuild_states_;
+  /** States to destroy in the background */
+  std::vector<StatePtr> prebuild_discard_;
+  /** States being created by the background thread */
+  std::vector<std::string> prebuild_building_;
+  /** States created by the background thread and not collected yet */
+  std::vector<std::pair<std::string, StatePtr>> prebuild_done_;
 
 private:
   /** Complete execution */
@@ -193,6 +220,19 @@ private:
 
   /** Setup next state */
   void next(Controller & ctl);
+  /** Create the states that may follow the current state in the background
+   *
+   * The previously created states that cannot follow the current state are destroyed in the background as well. If
+   * the background thread is still creating states for a previous state, its pending work is replaced and the states
+   * that are being created are collected on completion.
+   */
+  void prebuild(Controller & ctl);
+  /** Retrieve the states created in the background, never waits for the background thread */
+  void collectPrebuilt();
+  /** Move the states created in the background to prebuilt_, prebuild_mutex_ must be held */
+  void storePrebuilt();
+  /** Body of the background thread */
+  void prebuildLoop(StateFactory & factory);
 };
 
 } // namespace fsm
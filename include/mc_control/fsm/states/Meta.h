@@ -20,6 +20,7 @@ namespace fsm
  *
  * - Managed: if true, does not handle transitions
  * - StepByStep: same as FSM for the internal FSM (default: false)
+ * - Prebuild: same as FSM for the internal FSM (default: false)
  * - transitions: a transition map, similiar to the FSM controller (required if Managed is false)
  * - category: an arrray of strings, dictates where the executor adds elements into the GUI
  * - configs: can contain additional configuration for the states in the FSM
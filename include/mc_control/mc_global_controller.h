@@ -11,11 +11,15 @@
 
 #include <mc_rbdyn/RobotModule.h>
 
+#include <mc_rtc/LatencyHistogram.h>
 #include <mc_rtc/loader.h>
 #include <mc_rtc/log/Logger.h>
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
@@ -602,6 +606,106 @@ public:
   void setJointMotorCurrents(const std::string & robotName, const std::map<std::string, double> & currents);
   /** @} */
 
+  /** Sensors of a robot resolved once by \ref sensorHandles
+   *
+   * The handles give access to the sensors of the current controller's robot without any name lookup, this is meant
+   * for interfaces that provide the same sensors every iteration:
+   *
+   * \code{.cpp}
+   * // Once
+   * auto handles = gc.sensorHandles(robot, {"Accelerometer"}, {"LeftFootForceSensor", "RightFootForceSensor"}, {});
+   * // Every iteration
+   * gc.resolve(handles);
+   * handles.bodySensor(0).linearAcceleration(acc);
+   * for(size_t i = 0; i < wrenches.size(); ++i) { handles.forceSensor(i).wrench(wrenches[i]); }
+   * handles.data().encoderValues = q;
+   * \endcode
+   *
+   * Sensors are accessed in the order they were requested.
+   *
+   * The handles are invalidated when the controller changes (or is reset) and when the controller's robots are loaded,
+   * copied, removed or renamed (see mc_rbdyn::Robots::generation), \ref resolve checks this and resolves the handles
+   * again only when needed. The sensors of a robot are set when it is loaded.
+   */
+  struct MC_CONTROL_DLLAPI SensorHandles
+  {
+    /** Name of the robot */
+    std::string robot;
+    /** Names of the body sensors */
+    std::vector<std::string> bodySensors;
+    /** Names of the force sensors */
+    std::vector<std::string> forceSensors;
+    /** Names of the joints whose sensors are accessed */
+    std::vector<std::string> joints;
+
+    /** Access the i-th requested body sensor */
+    inline mc_rbdyn::BodySensor & bodySensor(size_t i)
+    {
+      return data_->bodySensors[bodySensorsIndex_[i]];
+    }
+
+    /** Access the i-th requested force sensor */
+    inline mc_rbdyn::ForceSensor & forceSensor(size_t i)
+    {
+      return data_->forceSensors[forceSensorsIndex_[i]];
+    }
+
+    /** Access the sensor of the i-th requested joint */
+    inline mc_rbdyn::JointSensor & jointSensor(size_t i)
+    {
+      return data_->jointSensors[jointSensorsIndex_[i]];
+    }
+
+    /** Access the robot's data (encoders, joint torques) */
+    inline mc_rbdyn::RobotData & data()
+    {
+      return *data_;
+    }
+
+  private:
+    mc_rbdyn::RobotData * data_ = nullptr;
+    std::vector<size_t> bodySensorsIndex_;
+    std::vector<size_t> forceSensorsIndex_;
+    std::vector<size_t> jointSensorsIndex_;
+    /** Controller generation for which the handles were resolved, 0 if the handles were never resolved */
+    size_t generation_ = 0;
+    /** Generation of the controller's robots for which the handles were resolved */
+    uint64_t robots_generation_ = 0;
+    friend struct MCGlobalController;
+  };
+
+  /** Resolve sensors of a robot of the current controller
+   *
+   * \param robot Name of the robot
+   *
+   * \param bodySensors Body sensors accessed through the handles
+   *
+   * \param forceSensors Force sensors accessed through the handles
+   *
+   * \param joints Joints whose sensors are accessed through the handles
+   *
+   * \throws If the robot or any of the sensors does not exist
+   */
+  SensorHandles sensorHandles(const std::string & robot,
+                              const std::vector<std::string> & bodySensors,
+                              const std::vector<std::string> & forceSensors,
+                              const std::vector<std::string> & joints);
+
+  /** Resolve the handles again if the controller or its robots changed since they were resolved
+   *
+   * This is cheap when nothing changed and can be called every iteration
+   *
+   * \throws If the robot or any of the sensors does not exist in the new controller
+   */
+  inline void resolve(SensorHandles & handles)
+  {
+    if(handles.generation_ != controller_generation_
+       || handles.robots_generation_ != controller().robots().generation())
+    {
+      resolveSensors(handles);
+    }
+  }
+
 protected:
   /** @name Internal sensing helpers
    *
@@ -703,6 +807,29 @@ public:
   /*! \brief Get the controller timestep */
   double timestep() const;
 
+  /*! \brief Latency statistics of a stage of \ref run
+   *
+   * The stages are:
+   * - Period: time between the start of two consecutive calls to \ref run
+   * - GlobalRun: duration of \ref run
+   * - ObserversRun, ControllerRun, SolverBuildAndSolve, SolverSolve, Log and Gui: duration of these steps in \ref run
+   *
+   * Deadline misses are counted against the controller timestep (except for Period) and the jitter is computed over
+   * the last second
+   *
+   * \throws If the stage does not exist
+   */
+  const mc_rtc::LatencyHistogram & latencyStatistics(const std::string & stage) const;
+
+  /*! \brief Summary of the latency statistics of every stage (durations in ms)
+   *
+   * This is also available from the controller's datastore as "Global::LatencyStatistics" and in the GUI
+   */
+  mc_rtc::Configuration latencyStatistics() const;
+
+  /*! \brief Discard the latency statistics of every stage */
+  void resetLatencyStatistics();
+
   /*! \brief Access the reference joint order
    *
    * This is provided by mc_rbdyn::RobotModule and represents the joint's order
@@ -894,6 +1021,7 @@ public:
     std::unordered_map<std::string, mc_rtc::Configuration> controllers_configs;
     double timestep = 0.002;
     bool include_halfsit_controller = true;
+    size_t init_threads = 1;
 
     bool enable_log = true;
     mc_rtc::Logger::Policy log_policy = mc_rtc::Logger::Policy::NON_THREADED;
@@ -902,6 +1030,9 @@ public:
 
     bool enable_gui_server = true;
     double gui_timestep = 0.05;
+    bool gui_delta = false;
+    double gui_full_state_period = 1.0;
+    bool gui_async = false;
     std::vector<std::string> gui_server_pub_uris{};
     std::vector<std::string> gui_server_rep_uris{};
 
@@ -921,6 +1052,8 @@ private:
   std::string next_ctrl = "";
   MCController * controller_ = nullptr;
   MCController * next_controller_ = nullptr;
+  /** Incremented every time the current controller changes, see SensorHandles */
+  size_t controller_generation_ = 1;
   std::unique_ptr<mc_rtc::ObjectLoader<MCController>> controller_loader_;
   std::map<std::string, std::shared_ptr<mc_control::MCController>> controllers;
   std::vector<mc_observers::ObserverPtr> observers_;
@@ -946,6 +1079,7 @@ private:
   {
     GlobalPlugin * plugin;
     duration_ms plugin_before_dt;
+    std::string name;
   };
   std::vector<PluginBefore> plugins_before_;
   std::vector<GlobalPlugin *> plugins_before_always_;
@@ -953,12 +1087,68 @@ private:
   {
     GlobalPlugin * plugin;
     duration_ms plugin_after_dt;
+    std::string name;
   };
   std::vector<PluginAfter> plugins_after_;
   std::vector<GlobalPlugin *> plugins_after_always_;
+  /** Runs the processing of an asynchronous plugin (see GlobalPlugin::GlobalPluginConfiguration::async) */
+  struct AsyncPlugin
+  {
+    AsyncPlugin(const std::string & name, GlobalPlugin * plugin, bool always, duration_ms deadline);
+    AsyncPlugin(const AsyncPlugin &) = delete;
+    AsyncPlugin & operator=(const AsyncPlugin &) = delete;
+    /** Wait for the current processing and join the thread */
+    ~AsyncPlugin();
+
+    /** Capture the controller state and start the processing, skip this iteration if the processing is still running
+     */
+    void trigger(MCGlobalController & gc);
+
+    /** Wait for the current processing to finish */
+    void wait();
+
+    std::string name;
+    GlobalPlugin * plugin;
+    /** True if the plugin runs regardless of the gc.running status */
+    bool always;
+    /** Time budget of GlobalPlugin::process */
+    duration_ms deadline;
+    /** Time spent in GlobalPlugin::capture */
+    duration_ms capture_dt{0};
+    /** Time spent in the last GlobalPlugin::process call (ms) */
+    std::atomic<double> process_dt{0};
+    /** Number of GlobalPlugin::process calls that exceeded the deadline */
+    std::atomic<uint64_t> overruns{0};
+    /** Number of iterations skipped because the processing was still running */
+    uint64_t skipped = 0;
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    /** True while a capture is waiting for or being processed */
+    bool busy_ = false;
+    bool running_ = true;
+    std::thread thread_;
+
+    void run();
+  };
+  /** Destroyed before the plugins so that no processing is running when they are released */
+  std::vector<std::unique_ptr<AsyncPlugin>> plugins_async_;
 
   void initGUI();
 
+  /** Create the controller \p name without adding it, returns nullptr if the controller is not available
+   *
+   * This can be called from several threads at once
+   */
+  std::shared_ptr<MCController> createController(const std::string & name, const mc_rtc::Configuration & ctl_config);
+
+  /** Add a controller returned by \ref createController */
+  bool addCreatedController(const std::string & name, std::shared_ptr<MCController> controller);
+
+  /** Resolve sensor handles for the current controller */
+  void resolveSensors(SensorHandles & handles);
+
   void start_log();
   void setup_log();
   std::map<std::string, bool> setup_logger_ = {};
@@ -973,6 +1163,29 @@ private:
   double solver_solve_t = 0;
   double framework_cost = 0;
 
+  /** Stages of run() whose latency statistics are collected */
+  enum class LatencyStage : size_t
+  {
+    Period,
+    GlobalRun,
+    ObserversRun,
+    ControllerRun,
+    SolverBuildAndSolve,
+    SolverSolve,
+    Log,
+    Gui,
+    Count
+  };
+  static const std::array<const char *, static_cast<size_t>(LatencyStage::Count)> latency_stages_;
+  std::array<std::unique_ptr<mc_rtc::LatencyHistogram>, static_cast<size_t>(LatencyStage::Count)> latency_;
+  /** Start of the previous call to run() */
+  std::chrono::nanoseconds last_run_t_{0};
+
+  inline void recordLatency(LatencyStage stage, double dt) noexcept
+  {
+    latency_[static_cast<size_t>(stage)]->record(dt);
+  }
+
   /** Reset controller-specific plugins
    *
    * When switching controllers, plugins that are enabled in both controllers are reset, new plugins are init
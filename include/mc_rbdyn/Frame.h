@@ -107,6 +107,7 @@ public:
   inline Frame & position(sva::PTransformd pos) noexcept
   {
     position_ = pos;
+    changed();
     return *this;
   }
 
@@ -119,6 +120,7 @@ public:
   inline Frame & velocity(sva::MotionVecd velocity) noexcept
   {
     velocity_ = velocity;
+    changed();
     return *this;
   }
 
@@ -157,6 +159,8 @@ protected:
   mutable mc_tvm::FramePtr tvm_frame_;
   /** Initialize the associated tvm Frame */
   virtual void init_tvm_frame() const;
+  /** Called when the frame's position or velocity is modified */
+  virtual void changed() noexcept {}
 };
 
 } // namespace mc_rbdyn
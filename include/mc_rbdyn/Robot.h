@@ -63,6 +63,7 @@ struct MC_RBDYN_DLLAPI Robot
 {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   friend struct Robots;
+  friend struct RobotFrame;
 
 public:
   using convex_pair_t = std::pair<std::string, S_ObjectPtr>;
@@ -288,7 +289,13 @@ public:
   /** Access MultiBody representation of the robot (const) */
   const rbd::MultiBody & mb() const;
 
-  /** Access MultiBodyConfig of the robot's mb() */
+  /** Access MultiBodyConfig of the robot's mb()
+   *
+   * \note The quantities cached by com(), comVelocity(), comAcceleration() and the robot's frames are invalidated by
+   * forwardKinematics(), forwardVelocity(), forwardAcceleration() and eulerIntegration(), if you modify the
+   * configuration by other means (e.g. copying another configuration or calling RBDyn directly) call
+   * invalidateKinematicsCache() afterwards
+   */
   rbd::MultiBodyConfig & mbc();
   /** Access MultiBodyConfig of the robot's mb() (const) */
   const rbd::MultiBodyConfig & mbc() const;
@@ -373,11 +380,17 @@ public:
    */
   const sva::MotionVecd & bodyAccB(const std::string & name) const;
 
-  /** Compute and returns the current robot's CoM */
+  /** Compute and returns the current robot's CoM
+   *
+   * The result is cached until the next call to forwardKinematics(), forwardVelocity(), forwardAcceleration(),
+   * eulerIntegration() or invalidateKinematicsCache()
+   *
+   * \warning This is not thread-safe: the first call after an update writes the cache, see RobotFrame::position()
+   */
   Eigen::Vector3d com() const;
-  /** Compute and returns the current robot's CoM velocity */
+  /** Compute and returns the current robot's CoM velocity, see com() for caching */
   Eigen::Vector3d comVelocity() const;
-  /** Compute and returns the current robot's CoM acceleration */
+  /** Compute and returns the current robot's CoM acceleration, see com() for caching */
   Eigen::Vector3d comAcceleration() const;
 
   /** Compute the gravity-free wrench in surface frame
@@ -1059,6 +1072,25 @@ public:
   /** Apply Euler integration to \p mbc using the robot's mb() and \p step timestep */
   void eulerIntegration(rbd::MultiBodyConfig & mbc, double step) const;
 
+  /** Invalidate the quantities computed from the robot's configuration (com() and frames' positions/velocities)
+   *
+   * The methods of the robot that update the configuration already do this, this is only required after modifying
+   * mbc() by other means
+   */
+  inline void invalidateKinematicsCache() noexcept
+  {
+    mbc_generation_++;
+  }
+
+  /** Incremented every time the kinematics are updated or a frame is changed
+   *
+   * Quantities computed from the configuration can compare this value to skip their update
+   */
+  inline uint64_t kinematicsGeneration() const noexcept
+  {
+    return mbc_generation_;
+  }
+
   /** Return the robot's global pose */
   const sva::PTransformd & posW() const;
   /** Set the robot's global pose.
@@ -1189,6 +1221,20 @@ private:
   std::unordered_map<std::string, RobotFramePtr> frames_;
   /** Mass of this robot */
   double mass_ = 0.0;
+  /** Incremented every time the kinematics are updated or a frame is changed, see com() */
+  uint64_t mbc_generation_ = 1;
+  /** Quantities computed from the configuration and the generation they were computed for */
+  struct KinematicsCache
+  {
+    uint64_t com_generation = 0;
+    Eigen::Vector3d com = Eigen::Vector3d::Zero();
+    uint64_t comVelocity_generation = 0;
+    Eigen::Vector3d comVelocity = Eigen::Vector3d::Zero();
+    uint64_t comAcceleration_generation = 0;
+    Eigen::Vector3d comAcceleration = Eigen::Vector3d::Zero();
+  };
+  /* mutable to allow updating the cache in const methods */
+  mutable KinematicsCache kinematics_cache_;
 
 protected:
   struct NewRobotToken
@@ -78,10 +78,18 @@ public:
   /** The body this frame is attached to */
   const std::string & body() const noexcept;
 
-  /** Computes the frame position */
+  /** Computes the frame position
+   *
+   * The result is cached until the robot's kinematics are updated or one of the robot's frames is modified, see
+   * Robot::com()
+   *
+   * \warning This is not thread-safe: the first call after an update writes the cache of this frame and of its
+   * parents. To use the frame from several threads, call position() (and velocity()) once on the calling thread after
+   * the update, the concurrent calls then only read the cache until the next update.
+   */
   sva::PTransformd position() const noexcept final;
 
-  /** Computes the frame velocity */
+  /** Computes the frame velocity, see position() for caching */
   sva::MotionVecd velocity() const noexcept final;
 
   /** Returns the transformation from the parent's frame/body to the frame */
@@ -103,6 +111,7 @@ public:
   inline RobotFrame & X_p_f(sva::PTransformd pt) noexcept
   {
     position_ = pt;
+    changed();
     return *this;
   }
 
@@ -168,8 +177,17 @@ protected:
   unsigned int bodyMbcIdx_;
   /** Force sensor attached (directly or indirectly) to this frame, nullptr if none */
   const ForceSensor * sensor_ = nullptr;
+  /** Cached position, valid if position_generation_ matches the robot's generation (see Robot::com()) */
+  mutable sva::PTransformd position_cache_;
+  mutable uint64_t position_generation_ = 0;
+  /** Cached velocity, valid if velocity_generation_ matches the robot's generation */
+  mutable sva::MotionVecd velocity_cache_;
+  mutable uint64_t velocity_generation_ = 0;
 
   void init_tvm_frame() const final;
+
+  /** Invalidate the cached positions and velocities of all the robot's frames */
+  void changed() noexcept final;
 };
 
 } // namespace mc_rbdyn
@@ -703,6 +703,9 @@ public:
 
 typedef std::shared_ptr<RobotModule> RobotModulePtr;
 
+/** Immutable RobotModule shared between the Robots instances that load it */
+typedef std::shared_ptr<const RobotModule> ConstRobotModulePtr;
+
 /*! \brief Converts limits provided by RBDyn parsers to bounds
  *
  * \param limits Limits as provided by RBDyn parsers
@@ -31,15 +31,21 @@ public:
   using size_type = std::vector<RobotPtr>::size_type;
   /** @} */
 
-  /** Give access to the underlying list of RobotModule objects */
-  const std::vector<mc_rbdyn::RobotModule> & robotModules() const;
+  /** Give access to the underlying list of RobotModule objects
+   *
+   * \note The modules are shared with the copies of this instance
+   */
+  const std::vector<ConstRobotModulePtr> & robotModules() const;
 
   /** Give access to the underlying list of rbd::MultiBody objects */
   std::vector<rbd::MultiBody> & mbs();
   /** Give access to the underlying list of rbd::MultiBody objects (const) */
   const std::vector<rbd::MultiBody> & mbs() const;
 
-  /** Give access to the underlying list of rbd::MultiBodyConfig objects */
+  /** Give access to the underlying list of rbd::MultiBodyConfig objects
+   *
+   * \note See Robot::mbc() regarding the quantities cached by each robot
+   */
   std::vector<rbd::MultiBodyConfig> & mbcs();
   /** Give access to the underlying list of rbd::MultiBodyConfig objects (const) */
   const std::vector<rbd::MultiBodyConfig> & mbcs() const;
@@ -47,6 +53,15 @@ public:
   /** True if the given robot is part of this intance */
   bool hasRobot(const std::string & name) const;
 
+  /** Incremented every time robots are loaded, copied, removed or renamed
+   *
+   * References to robots or to their data obtained for a previous generation might be invalid
+   */
+  inline uint64_t generation() const noexcept
+  {
+    return generation_;
+  }
+
   /** Give access to self for backward compatibility */
   inline mc_rbdyn::Robots & robots() noexcept
   {
@@ -86,6 +101,15 @@ public:
    */
   Robot & load(const std::string & name, const RobotModule & module, const LoadRobotParameters & params = {});
 
+  /** Load a single robot from a shared RobotModule with the provided parameters
+   *
+   * Contrary to the other overloads the module is not copied: it is shared with every robot loaded from it and their
+   * copies. It must not be modified after this call.
+   *
+   * \see load(const std::string &, const RobotModule &, const LoadRobotParameters &)
+   */
+  Robot & load(const std::string & name, ConstRobotModulePtr module, const LoadRobotParameters & params = {});
+
   /** Load a single robot from a RobotModule
    *
    * Use the name in the module to load the robot
@@ -256,7 +280,7 @@ protected:
   Robots(Robots && robots) = delete;
   Robots & operator=(Robots && robots) = delete;
 
-  RobotModuleVector robot_modules_;
+  std::vector<ConstRobotModulePtr> robot_modules_;
   std::vector<RobotPtr> robots_;
   std::vector<rbd::MultiBody> mbs_;
   std::vector<rbd::MultiBodyConfig> mbcs_;
@@ -265,6 +289,7 @@ protected:
   unsigned int envIndex_;
   void updateIndexes();
   std::unordered_map<std::string, unsigned int> robotNameToIndex_; ///< Correspondance between robot name and index
+  uint64_t generation_ = 0; ///< See generation()
 };
 
 /* Static pendant of the loader functions to create Robots directly */
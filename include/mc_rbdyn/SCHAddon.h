@@ -40,8 +40,32 @@ MC_RBDYN_DLLAPI void transform(S_Object & obj, const sva::PTransformd & t);
 
 MC_RBDYN_DLLAPI STP_BV * STPBV(const std::string & filename);
 
+/** Load a polyhedron from a qhull file
+ *
+ * The parsed polyhedra are kept in a process-wide cache keyed by the file path, modification time (with nanoseconds
+ * resolution where the platform provides it) and size. Loading the same file again returns a copy of the cached
+ * polyhedron instead of parsing the file.
+ *
+ * \see setPolyhedronCacheDirectory to also cache the polyhedra on disk
+ */
 MC_RBDYN_DLLAPI S_Polyhedron * Polyhedron(const std::string & filename);
 
+/** Set the directory used to store parsed polyhedra on disk
+ *
+ * When set, \ref Polyhedron stores every polyhedron it parses in a compact binary form in this directory and loads
+ * the binary form when the source file is unchanged. An empty directory (default) disables the on-disk cache.
+ */
+MC_RBDYN_DLLAPI void setPolyhedronCacheDirectory(const std::string & directory);
+
+/** Clear the in-memory polyhedron cache */
+MC_RBDYN_DLLAPI void clearPolyhedronCache();
+
+/** Remove \p filename from the in-memory polyhedron cache and from the on-disk cache (if any)
+ *
+ * The next \ref Polyhedron call parses the file again
+ */
+MC_RBDYN_DLLAPI void clearPolyhedronCache(const std::string & filename);
+
 MC_RBDYN_DLLAPI double distance(CD_Pair & pair, Eigen::Vector3d & p1, Eigen::Vector3d & p2);
 
 } // namespace mc_rbdyn
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/utils_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Detection of memory allocations in real-time code
+ *
+ * Allocations are only observed when the mc_rtc_alloc_hooks library is loaded, either by linking it into the executable
+ * or with LD_PRELOAD (Linux only, mc_rtc must be built with MC_RTC_ENABLE_ALLOCATION_TRACKING), e.g.:
+ *
+ * LD_PRELOAD=libmc_rtc_alloc_hooks.so mc_rtc_ticker
+ *
+ * The library replaces malloc/free and friends and reports every call made by a thread that is inside a \ref
+ * mc_rtc::alloc::Scope to the stage named by the innermost scope. Calls made outside of a scope are not counted.
+ *
+ * mc_control::MCGlobalController::run opens scopes around each of its stages so the allocations of the control loop
+ * are attributed to the plugins, observers, controller, solver, logger or GUI.
+ */
+
+namespace mc_rtc
+{
+
+namespace alloc
+{
+
+/** Allocations observed in a stage */
+struct StageStatistics
+{
+  /** Name of the stage */
+  std::string name;
+  /** Number of calls to malloc, calloc, realloc and the aligned variants */
+  uint64_t allocations = 0;
+  /** Number of calls to free */
+  uint64_t deallocations = 0;
+  /** Total number of bytes requested */
+  uint64_t bytes = 0;
+};
+
+/** An allocation whose call stack was captured */
+struct Allocation
+{
+  /** Stage that made the allocation */
+  std::string stage;
+  /** Requested size */
+  size_t size;
+  /** Symbolized call stack */
+  std::string stack;
+};
+
+/** True if the allocation hooks are loaded in this process */
+MC_RTC_UTILS_DLLAPI bool available() noexcept;
+
+/** True if allocations are currently counted (true by default once the hooks are loaded) */
+MC_RTC_UTILS_DLLAPI bool enabled() noexcept;
+
+/** Enable or disable the counting, this has no effect if the hooks are not loaded */
+MC_RTC_UTILS_DLLAPI void enable(bool enabled) noexcept;
+
+/** Keep the call stack of the first \p n allocations (at most 64) made after the last \ref reset, 0 disables the
+ * capture (default) */
+MC_RTC_UTILS_DLLAPI void captureStacks(size_t n) noexcept;
+
+/** Total number of allocations counted since the last \ref reset */
+MC_RTC_UTILS_DLLAPI uint64_t allocations() noexcept;
+
+/** Per-stage statistics, stages without any allocation or deallocation are not reported */
+MC_RTC_UTILS_DLLAPI std::vector<StageStatistics> statistics();
+
+/** Allocations whose stack was captured */
+MC_RTC_UTILS_DLLAPI std::vector<Allocation> stacks();
+
+/** Discard the statistics and the captured stacks */
+MC_RTC_UTILS_DLLAPI void reset() noexcept;
+
+/** Log the statistics and the captured stacks */
+MC_RTC_UTILS_DLLAPI void report();
+
+/** Attribute the allocations made by the calling thread to \p stage until this object is destroyed
+ *
+ * Scopes can be nested, the innermost scope is used.
+ */
+struct MC_RTC_UTILS_DLLAPI Scope
+{
+  /** \p stage must outlive the scope, it is copied (and possibly truncated) on the first allocation in the stage */
+  Scope(const char * stage) noexcept;
+
+  ~Scope() noexcept;
+
+  Scope(const Scope &) = delete;
+  Scope & operator=(const Scope &) = delete;
+
+private:
+  const char * previous_;
+};
+
+namespace detail
+{
+
+/** Called when the hooks library is loaded */
+MC_RTC_UTILS_DLLAPI void installHooks() noexcept;
+
+/** Called by the hooks on every allocation */
+MC_RTC_UTILS_DLLAPI void onAllocation(size_t size) noexcept;
+
+/** Called by the hooks on every deallocation */
+MC_RTC_UTILS_DLLAPI void onDeallocation() noexcept;
+
+} // namespace detail
+
+} // namespace alloc
+
+} // namespace mc_rtc
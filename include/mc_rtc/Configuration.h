@@ -696,6 +696,69 @@ public:
    */
   static Configuration fromMessagePack(const char * data, size_t size);
 
+  /*! \brief Read-only JSON data parsed in a scratch document
+   *
+   * This is meant for messages that are read once and only partially kept, e.g. the requests handled by
+   * mc_control::ControllerServer. The document is allocated from a buffer owned by the calling thread and reused by
+   * the next ScratchData created on this thread, so parsing does not allocate once the buffer is large enough. Only the
+   * entries that are copied into a Configuration are allocated.
+   *
+   * If a ScratchData is created while another one is alive on the same thread, it uses its own memory instead.
+   */
+  struct MC_RTC_UTILS_DLLAPI ScratchData
+  {
+    /*! \brief Parse JSON data
+     *
+     * \param data JSON data to load, an error is logged if it is invalid
+     */
+    ScratchData(const char * data);
+
+    ~ScratchData();
+
+    ScratchData(const ScratchData &) = delete;
+    ScratchData & operator=(const ScratchData &) = delete;
+
+    /** True if the data was loaded and its root is an object */
+    bool valid() const noexcept;
+
+    /*! \brief Read the string entry \p key
+     *
+     * \returns False if there is no such entry or if it is not a string, \p out is not modified in that case
+     */
+    bool read(const char * key, std::string & out) const;
+
+    /*! \brief Read the entry \p key as an array of strings
+     *
+     * \returns False if there is no such entry or if it is not an array of strings, \p out is not modified in that
+     * case
+     */
+    bool read(const char * key, std::vector<std::string> & out) const;
+
+    /*! \brief Copy the entry \p key into a new Configuration
+     *
+     * \returns An empty Configuration if there is no such entry
+     */
+    Configuration copy(const char * key) const;
+
+  private:
+    /** Actually the scratch state this data was parsed in */
+    void * impl_;
+  };
+
+  /*! \brief Set the directory used to cache parsed YAML files
+   *
+   * When set, YAML files loaded from disk are also stored in this directory in MessagePack form. Later loads of an
+   * unchanged file (same path, modification time and size) read the MessagePack data instead of parsing the YAML
+   * file. An empty directory (default) disables the cache.
+   *
+   * \param directory Cache directory, it is created if needed
+   *
+   */
+  static void cacheDirectory(const std::string & directory);
+
+  /*! \brief Directory used to cache parsed YAML files, empty if the cache is disabled */
+  static std::string cacheDirectory();
+
   /*! \brief Load more data into the configuration
    *
    * For any key existing in both objects:
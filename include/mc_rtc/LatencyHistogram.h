@@ -0,0 +1,122 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/utils_api.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace mc_rtc
+{
+
+/** Fixed-memory latency statistics of a periodic stage
+ *
+ * Durations are stored with a resolution of 1ns in a log-linear histogram (each power of two is split in 32 buckets,
+ * i.e. about 3% relative precision) from which percentiles are computed. The histogram also counts the samples that
+ * exceed a deadline and keeps the last samples to compute the jitter over a sliding window.
+ *
+ * A single thread should call \ref record, it does not allocate memory nor take a lock. The statistics can be read
+ * from any thread while samples are recorded: they are then approximate but never invalid.
+ */
+struct MC_RTC_UTILS_DLLAPI LatencyHistogram
+{
+  /** Number of buckets per power of two */
+  static constexpr size_t subBuckets = 32;
+
+  /** Durations are clamped to 2^maxMagnitude ns (about 18 minutes) */
+  static constexpr size_t maxMagnitude = 40;
+
+  /** Total number of buckets */
+  static constexpr size_t nBuckets = subBuckets * (maxMagnitude - 4);
+
+  /** Statistics computed in a single pass, durations are in ms */
+  struct Summary
+  {
+    uint64_t count = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+    /** Standard deviation over the sliding window */
+    double jitter = 0;
+    uint64_t deadline_misses = 0;
+  };
+
+  /** Constructor
+   *
+   * \param deadline Samples that exceed this duration (ms) are counted as deadline misses, 0 disables the counter
+   *
+   * \param window Number of samples used to compute the jitter
+   */
+  LatencyHistogram(double deadline = 0, size_t window = 1000);
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram & operator=(const LatencyHistogram &) = delete;
+
+  /** Record a duration (ms) */
+  void record(double duration) noexcept;
+
+  /** Number of recorded samples */
+  inline uint64_t count() const noexcept
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /** Mean duration (ms) */
+  double mean() const noexcept;
+
+  /** Duration (ms) below which \p p percent of the samples lie, e.g. percentile(99.9) */
+  double percentile(double p) const noexcept;
+
+  /** Longest recorded duration (ms) */
+  double max() const noexcept;
+
+  /** Standard deviation (ms) of the samples in the sliding window */
+  double jitter() const noexcept;
+
+  /** Number of samples that exceeded the deadline */
+  inline uint64_t deadlineMisses() const noexcept
+  {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  /** Deadline (ms) */
+  double deadline() const noexcept;
+
+  /** Change the deadline (ms), 0 disables the deadline */
+  void deadline(double deadline) noexcept;
+
+  /** Compute all the statistics */
+  Summary summary() const noexcept;
+
+  /** Discard all the samples, samples recorded concurrently might be partially lost */
+  void reset() noexcept;
+
+private:
+  std::array<std::atomic<uint64_t>, nBuckets> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+  std::atomic<uint64_t> misses_;
+  std::atomic<uint64_t> deadline_;
+  /** Last samples (ns) */
+  std::unique_ptr<std::atomic<uint64_t>[]> window_;
+  size_t window_size_;
+
+  /** Duration (ns) represented by the bucket \p idx */
+  static uint64_t bucketValue(size_t idx) noexcept;
+
+  /** Bucket of the duration \p ns */
+  static size_t bucketIndex(uint64_t ns) noexcept;
+
+  /** Compute \p n percentiles in a single pass over the buckets */
+  void percentiles(const double * p, double * out, size_t n) const noexcept;
+};
+
+} // namespace mc_rtc
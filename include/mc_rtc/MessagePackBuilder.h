@@ -64,8 +64,8 @@ constexpr bool is_like_uint64_t = is_like<uint64_t, T>();
 
 /** Helper class to build a MessagePack message
  *
- * After a message has been built, the builder object must be discarded to
- * create a new message.
+ * After a message has been built, the builder object must be discarded or
+ * reset to create a new message.
  */
 struct MC_RTC_UTILS_DLLAPI MessagePackBuilder
 {
@@ -79,6 +79,14 @@ struct MC_RTC_UTILS_DLLAPI MessagePackBuilder
   /** Destructor */
   ~MessagePackBuilder();
 
+  /** Start a new message in \p buffer after the previous one was finished
+   *
+   * Unlike creating a new builder, this does not allocate memory unless \p buffer is empty.
+   *
+   * \param buffer Buffer used to store the data, it may grow depending on the needs
+   */
+  void reset(std::vector<char> & buffer);
+
   /** @name Add data to the MessagePack (basic)
    *
    * These overload set allows to write basic data to the MessagePack
@@ -370,6 +378,12 @@ struct MC_RTC_UTILS_DLLAPI MessagePackBuilder
    */
   void write_object(const char * data, size_t s);
 
+  /** Size of the data written so far
+   *
+   * This can be used to locate an object in the buffer once the message is finished
+   */
+  size_t size() const;
+
   /** Finish building the message
    *
    * Afterwards, data cannot be appended to the builder
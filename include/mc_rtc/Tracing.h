@@ -0,0 +1,129 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/utils_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/** Low-overhead tracing of nested spans
+ *
+ * Spans are recorded into a ring buffer owned by the thread that records them and can be exported in the Chrome trace
+ * format (readable by chrome://tracing or https://ui.perfetto.dev) with \ref mc_rtc::trace::dump
+ *
+ * The instrumentation macros (\ref MC_RTC_TRACE_SPAN and \ref MC_RTC_TRACE_TICK) are only active when mc_rtc is built
+ * with MC_RTC_ENABLE_TRACING, they expand to nothing otherwise.
+ */
+
+namespace mc_rtc
+{
+
+namespace trace
+{
+
+/** A recorded span */
+struct Event
+{
+  /** Category of the span, must be a string literal */
+  const char * category;
+  /** Name of the span, truncated if needed */
+  char name[48];
+  /** Start of the span (ns, steady clock) */
+  uint64_t start;
+  /** End of the span (ns, steady clock) */
+  uint64_t end;
+};
+
+/** Current time in ns (steady clock) */
+MC_RTC_UTILS_DLLAPI uint64_t now() noexcept;
+
+/** True if spans are currently recorded (true by default) */
+MC_RTC_UTILS_DLLAPI bool enabled() noexcept;
+
+/** Enable or disable the recording of spans */
+MC_RTC_UTILS_DLLAPI void enable(bool enabled) noexcept;
+
+/** Number of events kept per thread, only affects threads that have not recorded anything yet (default: 16384) */
+MC_RTC_UTILS_DLLAPI void bufferSize(size_t size);
+
+/** Name the calling thread in the exported traces */
+MC_RTC_UTILS_DLLAPI void threadName(const std::string & name);
+
+/** Record an event in the calling thread's buffer, the buffer is created by the first call on a given thread */
+MC_RTC_UTILS_DLLAPI void record(const Event & event) noexcept;
+
+/** Mark the start of a control tick, used by \ref dump to select the last ticks */
+MC_RTC_UTILS_DLLAPI void tick() noexcept;
+
+/** Write the events recorded during the last \p ticks ticks (on every thread) as Chrome trace JSON
+ *
+ * Events that are overwritten while the buffers are read are discarded.
+ *
+ * \param path Output file
+ *
+ * \param ticks Number of ticks to export, 0 exports all the recorded events
+ *
+ * \returns False if the file could not be written
+ */
+MC_RTC_UTILS_DLLAPI bool dump(const std::string & path, size_t ticks = 0);
+
+/** Records a span from its construction to its destruction */
+struct MC_RTC_UTILS_DLLAPI Span
+{
+  /** Span named \p name in the "mc_rtc" category */
+  inline Span(const char * name) noexcept : active_(enabled())
+  {
+    if(active_)
+    {
+      start("mc_rtc", name);
+    }
+  }
+
+  /** Span named \p name in the category \p category (must be a string literal) */
+  inline Span(const char * category, const std::string & name) noexcept : active_(enabled())
+  {
+    if(active_)
+    {
+      start(category, name.c_str());
+    }
+  }
+
+  inline ~Span()
+  {
+    if(active_)
+    {
+      event_.end = now();
+      record(event_);
+    }
+  }
+
+  Span(const Span &) = delete;
+  Span & operator=(const Span &) = delete;
+
+private:
+  bool active_;
+  Event event_;
+
+  void start(const char * category, const char * name) noexcept;
+};
+
+} // namespace trace
+
+} // namespace mc_rtc
+
+#define MC_RTC_TRACE_CONCAT_(A, B) A##B
+#define MC_RTC_TRACE_CONCAT(A, B) MC_RTC_TRACE_CONCAT_(A, B)
+
+#ifdef MC_RTC_ENABLE_TRACING
+/** Record a span until the end of the current scope, see mc_rtc::trace::Span for the possible arguments */
+#  define MC_RTC_TRACE_SPAN(...) mc_rtc::trace::Span MC_RTC_TRACE_CONCAT(mc_rtc_trace_span_, __LINE__)(__VA_ARGS__)
+/** Mark the start of a control tick */
+#  define MC_RTC_TRACE_TICK() mc_rtc::trace::tick()
+#else
+#  define MC_RTC_TRACE_SPAN(...)
+#  define MC_RTC_TRACE_TICK()
+#endif
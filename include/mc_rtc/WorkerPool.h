@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/utils_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mc_rtc
+{
+
+/** A fixed set of worker threads that run indexed jobs
+ *
+ * The threads are created by the constructor and wait for work until the pool is destroyed. \ref run distributes the
+ * indices of a job over the workers and the calling thread and returns once every index has been processed. It does
+ * not allocate memory so it can be used from the real-time thread.
+ *
+ * Each index is processed exactly once but the order and the thread used are not specified: the job should write its
+ * result to a location that only depends on the index.
+ *
+ * Waiting threads (idle workers and the thread calling \ref run while the workers finish) first spin for a
+ * configurable duration and then sleep on a condition variable. Spinning avoids the cost of a wake-up (a futex call
+ * and the scheduler latency) when jobs follow each other closely, e.g. with workers pinned to dedicated CPUs and a
+ * spin duration longer than the control period, but it keeps the CPU busy. Sleeping frees the CPU: this is required
+ * when the workers share CPUs with other real-time threads since a spinning thread does not let lower priority
+ * threads run under SCHED_FIFO. The mutex is only taken by \ref run when a thread actually sleeps.
+ */
+struct MC_RTC_UTILS_DLLAPI WorkerPool
+{
+  /** Default spin duration, see \ref WorkerPool */
+  static constexpr std::chrono::microseconds default_spin{50};
+
+  /** Create the worker threads
+   *
+   * \param threads Number of worker threads, the thread calling \ref run also processes jobs
+   *
+   * \param cpus If not empty, the i-th worker is pinned to the CPU cpus[i % cpus.size()] (only supported on Linux)
+   *
+   * \param spin Time spent spinning before sleeping when waiting for a job or for the workers to finish
+   */
+  WorkerPool(size_t threads,
+             const std::vector<int> & cpus = {},
+             std::chrono::microseconds spin = default_spin);
+
+  /** Stop and join the worker threads */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  /** Number of worker threads */
+  inline size_t size() const noexcept
+  {
+    return threads_.size();
+  }
+
+  /** Call job(i) for every i in [0, n) and wait for completion
+   *
+   * \param n Number of indices
+   *
+   * \param job Callable with a size_t argument, it must not throw
+   *
+   * \note Calls to run must not overlap
+   */
+  template<typename Callback>
+  void run(size_t n, Callback && job)
+  {
+    using CallbackT = std::remove_reference_t<Callback>;
+    run_impl(
+        n, [](const void * data, size_t i) { (*static_cast<CallbackT *>(const_cast<void *>(data)))(i); },
+        std::addressof(job));
+  }
+
+private:
+  using job_t = void (*)(const void *, size_t);
+
+  std::vector<std::thread> threads_;
+  std::chrono::microseconds spin_;
+  std::mutex mutex_;
+  /** Sleeping workers wait on this for a new job */
+  std::condition_variable cv_;
+  /** A sleeping \ref run waits on this for the workers to finish */
+  std::condition_variable done_cv_;
+  /** Incremented for every job, workers wait for it to change */
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<bool> stop_{false};
+  /** Number of workers sleeping on cv_ */
+  std::atomic<size_t> sleeping_{0};
+  /** True while \ref run sleeps on done_cv_ */
+  std::atomic<bool> waiting_{false};
+  /** Current job, published by the generation_ increment */
+  job_t job_ = nullptr;
+  const void * data_ = nullptr;
+  size_t n_ = 0;
+  /** Next index to process */
+  std::atomic<size_t> next_{0};
+  /** Number of workers still processing the current job */
+  std::atomic<size_t> active_{0};
+
+  void run_impl(size_t n, job_t job, const void * data);
+
+  /** Wait until generation_ differs from \p generation and update it, returns false if the pool is stopping */
+  bool wait_job(uint64_t & generation);
+
+  /** Wait until every worker has finished the current job */
+  void wait_done();
+
+  /** Process indices of the current job until none is left */
+  void process();
+};
+
+} // namespace mc_rtc
@@ -38,6 +38,12 @@ struct MC_RTC_GUI_DLLAPI StateBuilder
    */
   static constexpr int8_t PROTOCOL_VERSION = 4;
 
+  /** Version of the messages written by \ref updateDelta
+   *
+   * Version 5 introduced partial states, only clients that support them should receive these messages
+   */
+  static constexpr int8_t DELTA_PROTOCOL_VERSION = 5;
+
   /** Constructor */
   StateBuilder();
 
@@ -333,6 +339,113 @@ struct MC_RTC_GUI_DLLAPI StateBuilder
    */
   size_t update(std::vector<char> & data);
 
+  /** Update the GUI message with the elements that changed since the last full state
+   *
+   * Messages are written with \ref DELTA_PROTOCOL_VERSION. A full state has the same layout as the message produced by
+   * \ref update(std::vector<char> &) with an extra identifier: [version, data, elements, plots, id]
+   *
+   * A partial state only holds the elements whose serialization differs from the last full state:
+   * [version, nil, nil, plots, id, [[index, element], ...]] where id is the identifier of the full state the changes
+   * apply to and index is the position of the element in a depth-first traversal of the full state (the elements of a
+   * category then its sub-categories)
+   *
+   * Since partial states are relative to the last full state, a client only needs the latest full state and the latest
+   * partial state to reconstruct the GUI.
+   *
+   * This is equivalent to \ref capture followed by Encoder::updateDelta
+   *
+   * \param data Will hold binary data representing the GUI
+   *
+   * \param full Write a full state, a full state is also written on the first call and after elements, categories or
+   * static data have been added or removed
+   *
+   * \returns Effective size of the GUI message
+   */
+  size_t updateDelta(std::vector<char> & data, bool full = false);
+
+  /** Values of the GUI captured by \ref capture
+   *
+   * A snapshot holds everything that is needed to build a GUI message without accessing the elements, the message can
+   * be built by an Encoder in a different thread. The buffers are re-used by successive captures.
+   */
+  struct MC_RTC_GUI_DLLAPI Snapshot
+  {
+    /** Layout of a category */
+    struct Category
+    {
+      /** Name of the category */
+      std::string name;
+      /** Number of elements in the category */
+      size_t elements;
+      /** Number of sub-categories */
+      size_t sub;
+    };
+    /** Static data */
+    std::vector<char> data;
+    /** Size of the static data */
+    size_t data_size = 0;
+    /** Elements serialized in a depth-first traversal of the GUI */
+    std::vector<char> elements;
+    /** Offset of each element in elements (and end of the last one) */
+    std::vector<size_t> offsets;
+    /** Categories in a depth-first traversal of the GUI */
+    std::vector<Category> categories;
+    /** Plots data */
+    std::vector<char> plots;
+    /** Size of the plots data */
+    size_t plots_size = 0;
+    /** True if elements or categories were added or removed since the previous capture */
+    bool reset = true;
+  };
+
+  /** Builds GUI messages from snapshots
+   *
+   * The encoder keeps the last full state, partial states are relative to this state
+   */
+  struct MC_RTC_GUI_DLLAPI Encoder
+  {
+    /** Write the same message as StateBuilder::update(std::vector<char> &) from a snapshot */
+    size_t update(const Snapshot & snapshot, std::vector<char> & data) const;
+
+    /** Write the same message as StateBuilder::updateDelta from a snapshot */
+    size_t updateDelta(const Snapshot & snapshot, std::vector<char> & data, bool full = false);
+
+  private:
+    /** Identifier of the last full state */
+    uint64_t id_ = 0;
+    /** Static data of the last full state */
+    std::vector<char> data_;
+    /** Elements of the last full state */
+    std::vector<char> elements_;
+    /** Offset of each element in elements_ (and end of the last one) */
+    std::vector<size_t> offsets_;
+    /** Elements that changed since the last full state */
+    std::vector<size_t> changed_;
+
+    /** Write a message with the static data, the elements and the plots of a snapshot */
+    static void write(mc_rtc::MessagePackBuilder & builder, const Snapshot & snapshot, size_t size, int8_t version);
+
+    /** Write a category from a snapshot and its sub-categories
+     *
+     * \param category Index of the category in snapshot.categories, incremented for every category written
+     *
+     * \param idx Index of the next element in the snapshot, incremented for every element written
+     */
+    static void writeCategory(mc_rtc::MessagePackBuilder & builder,
+                              const Snapshot & snapshot,
+                              size_t & category,
+                              size_t & idx);
+  };
+
+  /** Capture the current state of the GUI
+   *
+   * This calls every element and plot callback, the GUI message can then be built from the snapshot by an Encoder
+   * without accessing the StateBuilder
+   *
+   * \param snapshot Snapshot to update
+   */
+  void capture(Snapshot & snapshot);
+
   /** Update the plots only */
   void update();
 
@@ -386,6 +499,12 @@ private:
   std::vector<char> data_buffer_;
   /** Holds data's binary size */
   size_t data_buffer_size_ = 0;
+  /** True if elements or categories were added or removed since the last capture */
+  bool tree_changed_ = true;
+  /** Snapshot used by updateDelta */
+  Snapshot delta_snapshot_;
+  /** Encoder used by updateDelta */
+  Encoder delta_encoder_;
   struct Category;
   struct MC_RTC_GUI_DLLAPI ElementStore
   {
@@ -438,6 +557,15 @@ private:
   /** Update the GUI data state for a given category */
   void update(mc_rtc::MessagePackBuilder & builder, Category & category);
 
+  /** Write the plots data */
+  void updatePlots(mc_rtc::MessagePackBuilder & builder);
+
+  /** Serialize every element of a category and its sub-categories in a snapshot
+   *
+   * \param idx Index of the next category in the snapshot
+   */
+  void capture(mc_rtc::MessagePackBuilder & builder, Category & category, Snapshot & snapshot, size_t & idx);
+
   /** Remove all elements associated to the given in the given category */
   void removeElements(Category & category, void * source);
 
@@ -58,6 +58,7 @@ void StateBuilder::addElementImpl(void * source,
     return;
   }
   cat.elements.emplace_back(element, cat, stacking, source);
+  tree_changed_ = true;
   if(rem == 0)
   {
     cat.id += 1;
@@ -296,6 +296,11 @@ protected:
   Loader::handle_map_t handles_;
   mc_rtc::DataStore callbacks_;
   std::unordered_map<std::string, ObjectDeleter> deleters_;
+  /** Protects deleters_ since objects can be created from several threads */
+  std::mutex deleters_mtx_;
+
+  /** Deleter for the object \p name */
+  ObjectDeleter deleter(const std::string & name);
 
   /** Internal function to create a raw pointer */
   template<typename... Args>
@@ -155,9 +155,10 @@ template<typename T>
 template<typename... Args>
 T * ObjectLoader<T>::create_from_handles(const std::string & name, Args... args)
 {
+  auto & handle = *handles_.at(name);
   unsigned int args_passed = 1 + sizeof...(Args);
   unsigned int args_required = args_passed;
-  auto create_args_required = handles_[name]->template get_symbol<unsigned int (*)()>("create_args_required");
+  auto create_args_required = handle.template get_symbol<unsigned int (*)()>("create_args_required");
   if(create_args_required != nullptr)
   {
     args_required = create_args_required();
@@ -168,15 +169,14 @@ T * ObjectLoader<T>::create_from_handles(const std::string & name, Args... args)
                                                   args_passed, name, args_required);
   }
   auto create_fn =
-      handles_[name]->template get_symbol<T * (*)(const std::string &, const typename std::decay<Args>::type &...)>(
-          "create");
+      handle.template get_symbol<T * (*)(const std::string &, const typename std::decay<Args>::type &...)>("create");
   if(create_fn == nullptr)
   {
-    mc_rtc::log::error_and_throw<LoaderException>("Failed to resolve create symbol in {}", handles_[name]->path());
+    mc_rtc::log::error_and_throw<LoaderException>("Failed to resolve create symbol in {}", handle.path());
   }
   if constexpr(details::has_set_loading_location_v<T>)
   {
-    T::set_loading_location(handles_[name]->dir());
+    T::set_loading_location(handle.dir());
   }
   if constexpr(details::has_set_name_v<T>)
   {
@@ -187,12 +187,13 @@ T * ObjectLoader<T>::create_from_handles(const std::string & name, Args... args)
   {
     mc_rtc::log::error_and_throw<LoaderException>("Call to create for object {} failed", name);
   }
+  std::lock_guard<std::mutex> lock(deleters_mtx_);
   if(!deleters_.count(name))
   {
-    auto delete_fn = handles_[name]->template get_symbol<void (*)(T *)>("destroy");
+    auto delete_fn = handle.template get_symbol<void (*)(T *)>("destroy");
     if(delete_fn == nullptr)
     {
-      mc_rtc::log::error_and_throw<LoaderException>("Symbol destroy not found in {}", handles_[name]->path());
+      mc_rtc::log::error_and_throw<LoaderException>("Symbol destroy not found in {}", handle.path());
     }
     deleters_[name] = ObjectDeleter(delete_fn);
   }
@@ -217,15 +218,23 @@ void ObjectLoader<T>::register_object(const std::string & name, std::function<Re
   static_assert(std::is_base_of<T, RetT>::value,
                 "This object cannot be registered as it does not derive from the loader base-class");
   callbacks_.make_call(name, [callback](const Args &... args) -> T * { return callback(args...); });
+  std::lock_guard<std::mutex> lock(deleters_mtx_);
   deleters_[name] = ObjectDeleter([](T * ptr) { delete static_cast<RetT *>(ptr); });
 }
 
+template<typename T>
+typename ObjectLoader<T>::ObjectDeleter ObjectLoader<T>::deleter(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock(deleters_mtx_);
+  return deleters_[name];
+}
+
 template<typename T>
 template<typename... Args>
 std::shared_ptr<T> ObjectLoader<T>::create_object(const std::string & name, Args... args)
 {
   T * ptr = create(name, std::forward<Args>(args)...);
-  return std::shared_ptr<T>(ptr, deleters_[name]);
+  return std::shared_ptr<T>(ptr, deleter(name));
 }
 
 template<typename T>
@@ -233,7 +242,7 @@ template<typename... Args>
 typename ObjectLoader<T>::unique_ptr ObjectLoader<T>::create_unique_object(const std::string & name, Args... args)
 {
   T * ptr = create(name, std::forward<Args>(args)...);
-  return unique_ptr(ptr, deleters_[name]);
+  return unique_ptr(ptr, deleter(name));
 }
 
 } // namespace mc_rtc
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2015-2021 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/log/iterate_binary_log.h>
+
+#include <memory>
+
+namespace mc_rtc
+{
+
+namespace log
+{
+
+struct BinaryLogReaderImpl;
+
+/** Random access to an on-disk binary log recorded by mc_rtc
+ *
+ * Since version 2, every keyframe written by mc_rtc::Logger is a checkpoint: it holds the full key table and every
+ * value. When it closes a log, the Logger writes the offset, index and time of every checkpoint in an index file next
+ * to the log (see \ref index_path).
+ *
+ * Seeking moves to the closest checkpoint before the requested position then decodes the frames until the requested
+ * position is reached, this takes at most Logger::keyframe_period frames.
+ *
+ * If the index is missing or outdated (e.g. the controller crashed or the log was produced by mc_bin_utils) it is
+ * rebuilt by reading the log once. Logs written before version 2 only have a checkpoint at the start of the log.
+ */
+struct MC_RTC_UTILS_DLLAPI BinaryLogReader
+{
+  /** Open a log
+   *
+   * \param fpath Path to the binary log file
+   *
+   * \param time Key used as time source, see \ref iterate_binary_log
+   */
+  BinaryLogReader(const std::string & fpath, const std::string & time = "t");
+
+  ~BinaryLogReader();
+
+  BinaryLogReader(const BinaryLogReader &) = delete;
+  BinaryLogReader & operator=(const BinaryLogReader &) = delete;
+
+  /** True if the log was opened successfully */
+  bool valid() const;
+
+  /** Number of frames in the log
+   *
+   * \note This builds the index if necessary
+   */
+  size_t size();
+
+  /** Index of the next frame provided by \ref iterate */
+  size_t iteration() const;
+
+  /** Seek to the first frame whose time is greater or equal than \p t
+   *
+   * Returns false if the log has no such frame
+   */
+  bool seek(double t);
+
+  /** Seek to the given frame
+   *
+   * Returns false if the log has no such frame
+   */
+  bool seekIteration(size_t iteration);
+
+  /** Iterate over the log from the current position
+   *
+   * The callback receives the same arguments as in \ref iterate_binary_log. The keys are always provided for the first
+   * frame after a seek.
+   *
+   * \param callback Called for every frame
+   *
+   * \param extract If true, data is available as their original C++ type
+   *
+   * \returns True if the end of the log was reached without error, false otherwise
+   */
+  bool iterate(const binary_log_copy_callback & callback, bool extract);
+
+  /** Iterate over the log from the current position, see \ref iterate */
+  bool iterate(const binary_log_callback & callback, bool extract);
+
+  /** Path to the index of a log */
+  static std::string index_path(const std::string & fpath);
+
+private:
+  std::unique_ptr<BinaryLogReaderImpl> impl_;
+};
+
+} // namespace log
+
+} // namespace mc_rtc
@@ -9,6 +9,8 @@
 
 #include <SpaceVecAlg/SpaceVecAlg>
 
+#include <deque>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -19,25 +21,81 @@ namespace mc_rtc
 namespace log
 {
 
+namespace internal
+{
+
+struct MappedLog;
+
+} // namespace internal
+
 /** From an on-disk binary log recorded by mc_rtc, return a flat structure */
 struct MC_RTC_UTILS_DLLAPI FlatLog
 {
   /** Default constructor, empty log */
-  FlatLog() = default;
+  FlatLog();
 
   /** Load a file into the log */
   FlatLog(const std::string & fpath);
 
+  /** Load a file into the log, see load(const std::string &, bool) */
+  FlatLog(const std::string & fpath, bool lazy);
+
+  ~FlatLog();
+
   FlatLog(const FlatLog &) = delete;
   FlatLog & operator=(const FlatLog &) = delete;
 
-  FlatLog(FlatLog &&) = default;
-  FlatLog & operator=(FlatLog &&) = default;
+  FlatLog(FlatLog &&);
+  FlatLog & operator=(FlatLog &&);
 
   /** Load a file into the log, erase the current content of the flat log */
   void load(const std::string & fpath);
 
-  /** Append a file into the flat log, the resulting content is the concatenation of the two logs*/
+  /** Load a file into the log, erase the current content of the flat log
+   *
+   * If \p lazy is true, the binary log is memory-mapped and only scanned for frame boundaries and key changes. The data
+   * of an entry is decoded the first time it is accessed and kept afterwards. This is much faster when only a few
+   * entries of a large log are used.
+   *
+   * \note The log file must not be modified while the FlatLog is alive. Flat files and logs written before version 1
+   * are always loaded fully.
+   *
+   * \note Accessing an entry for the first time decodes it under a lock so the const accessors can be used from
+   * multiple threads. The non-const members (load, append, decodeAll...) still require external synchronization.
+   *
+   * \param fpath Path to the log
+   *
+   * \param lazy Decode entries on access
+   */
+  void load(const std::string & fpath, bool lazy);
+
+  /** Load the [from, to] time range of a binary log, erase the current content of the flat log
+   *
+   * Only the frames in the time range are read, see BinaryLogReader
+   *
+   * \param fpath Path to the binary log
+   *
+   * \param from Start time
+   *
+   * \param to End time
+   */
+  void load(const std::string & fpath, double from, double to);
+
+  /** Decode every entry of a lazily loaded log and release the mapped log
+   *
+   * The frames of the log are split in \p jobs chunks that are decoded in parallel. In version 2 logs, chunks start
+   * on a keyframe since the other frames depend on the previous values.
+   *
+   * Does nothing if the log was not loaded lazily or was already decoded.
+   *
+   * \param jobs Number of threads used to decode the log, uses the number of hardware threads if 0
+   */
+  void decodeAll(size_t jobs = 1);
+
+  /** Append a file into the flat log, the resulting content is the concatenation of the two logs
+   *
+   * If the log was loaded lazily, every entry is decoded first
+   */
   void append(const std::string & fpath);
 
   /** Returns the size of the log */
@@ -122,6 +180,56 @@ struct MC_RTC_UTILS_DLLAPI FlatLog
   template<typename T>
   const T * getRaw(const std::string & entry, size_t i) const;
 
+  /** A non-owning view of contiguous data in the log */
+  template<typename T>
+  struct span
+  {
+    const T * begin() const noexcept
+    {
+      return data_;
+    }
+    const T * end() const noexcept
+    {
+      return data_ + size_;
+    }
+    const T * data() const noexcept
+    {
+      return data_;
+    }
+    size_t size() const noexcept
+    {
+      return size_;
+    }
+    bool empty() const noexcept
+    {
+      return size_ == 0;
+    }
+    const T & operator[](size_t i) const noexcept
+    {
+      return data_[i];
+    }
+
+    const T * data_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  /** Get a typed entry without copy
+   *
+   * The span has one element per index in the log. When the data is not available at a given index (the entry is
+   * missing, has another type or was not logged at that time) a default-constructed value is stored, use getRaw(entry,
+   * i) to check that data is available.
+   *
+   * The span is empty if the entry was never logged with the requested type and remains valid until the log is
+   * modified.
+   *
+   * \note Not available for bool entries
+   *
+   * \param entry Entry to get
+   *
+   */
+  template<typename T>
+  span<T> getSpan(const std::string & entry) const;
+
   struct record
   {
     using unique_void_ptr = std::unique_ptr<void, void (*)(void const *)>;
@@ -134,26 +242,98 @@ struct MC_RTC_UTILS_DLLAPI FlatLog
     LogType type = mc_rtc::log::LogType::None;
     unique_void_ptr data;
   };
+  /** Data of an entry for a given type
+   *
+   * Data is stored in a contiguous typed array (see typed_column) with one value per index in the log and a validity
+   * mask
+   */
+  struct column
+  {
+    column(LogType t) : type(t) {}
+    virtual ~column() = default;
+    /** Resize the column, new values are not available */
+    virtual void resize(size_t size) = 0;
+    /** Type of the data */
+    LogType type;
+    /** Non-zero if the data is available at a given index
+     *
+     * Bytes rather than bits so that distinct indexes can be filled from different threads
+     */
+    std::vector<uint8_t> valid;
+  };
+  template<typename T>
+  struct typed_column : public column
+  {
+    /** bool values are stored in a deque since std::vector<bool> does not store bool objects */
+    using data_t = std::conditional_t<std::is_same_v<T, bool>, std::deque<bool>, std::vector<T>>;
+    typed_column() : column(GetLogType<T>::type) {}
+    void resize(size_t size) override
+    {
+      data.resize(size);
+      valid.resize(size, 0);
+    }
+    data_t data;
+  };
   struct entry
   {
     std::string name;
-    std::vector<record> records;
+    /** Usually a single column, one column per type if the entry type changed */
+    std::vector<std::unique_ptr<column>> columns;
+    /** False until the columns of a lazily loaded entry are decoded */
+    bool decoded = true;
   };
 
 private:
-  std::vector<entry> data_;
+  /** Mutable so that lazily loaded entries can be decoded on access */
+  mutable std::vector<entry> data_;
+  /** Number of indexes in the log */
+  size_t size_ = 0;
+  /** Mapped binary log, only set when the log was loaded lazily */
+  std::unique_ptr<internal::MappedLog> mapped_;
+
+  /** Retrieve a given entry, throws if the entry does not exist
+   *
+   * The entry is decoded if necessary
+   */
+  const entry & at(const std::string & entry) const;
 
-  /** Retrieve records for a given entry */
-  const std::vector<record> & at(const std::string & entry) const;
+  /** Decode the columns of a lazily loaded entry, must be called with the decode lock held (see \ref at) */
+  void decode(entry & e) const;
+
+  /** Retrieve the column of an entry for a given type, nullptr if the entry was never logged with that type */
+  template<typename T>
+  const typed_column<T> * column_at(const std::string & entry) const;
 
   /** Retrieve the index of a given entry, creates the entry if it doesn't exist */
-  size_t index(const std::string & entry, size_t size);
+  size_t index(const std::string & entry);
+
+  /** Retrieve the column of an entry for a given type, creates the column if it doesn't exist */
+  template<typename T>
+  static typed_column<T> & get_or_add_column(entry & e);
+
+  /** Store a record in an entry at a given index */
+  void push(entry & e, size_t i, record && r);
+
+  /** Map a binary log and find its frames, returns false if the log cannot be loaded lazily */
+  bool loadLazy(const std::string & fpath);
+
+  /** Decode frames [start, end) of the mapped log into the pre-allocated columns of the \p pending entries
+   *
+   * Returns false if a frame could not be decoded
+   */
+  bool decodeFrames(size_t start, size_t end, const std::unordered_map<std::string, entry *> & pending) const;
+
+  /** Resize every column to the size of the log */
+  void finalize();
 
   /** Append a flat file to the log, all entries will be either double or strings */
   void appendFlat(const std::string & fpath);
 
   /** Append a binary file to the log */
   void appendBin(const std::string & fpath);
+
+  /** Append part of a binary log, see load(const std::string &, double, double) */
+  void appendBin(const std::string & fpath, double from, double to);
 };
 
 } // namespace log
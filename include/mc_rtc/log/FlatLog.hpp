@@ -17,38 +17,30 @@ namespace log
 namespace details
 {
 
+/** Check that T is the type used to store its LogType in a FlatLog */
 template<typename T>
-struct CheckLogType
+constexpr void check_storage_type()
 {
-  static bool check(const LogType & t)
-  {
-    return t == mc_rtc::log::GetLogType<T>::type;
-  }
-};
-
-template<typename T>
-const T * record_cast(const FlatLog::record & r)
-{
-  if(CheckLogType<T>::check(r.type))
-  {
-    return static_cast<const T *>(r.data.get());
-  }
-  return nullptr;
+  static_assert(std::is_same_v<T, typename LogStorage<GetLogType<T>::type>::type>,
+                "FlatLog data can only be retrieved with the type used to store it (see log::LogStorage)");
 }
 
+} // namespace details
+
 template<typename T>
-bool convert(const FlatLog::record & r, T & out)
+auto FlatLog::column_at(const std::string & entry) const -> const typed_column<T> *
 {
-  const T * ptr = record_cast<T>(r);
-  if(ptr)
+  details::check_storage_type<T>();
+  for(const auto & c : at(entry).columns)
   {
-    out = *ptr;
+    if(c->type == GetLogType<T>::type)
+    {
+      return static_cast<const typed_column<T> *>(c.get());
+    }
   }
-  return ptr;
+  return nullptr;
 }
 
-} // namespace details
-
 template<typename T>
 std::vector<const T *> FlatLog::getRaw(const std::string & entry) const
 {
@@ -57,12 +49,17 @@ std::vector<const T *> FlatLog::getRaw(const std::string & entry) const
     log::error("No entry named {} in the loaded log", entry);
     return {};
   }
-  std::vector<const T *> ret;
-  const auto & data = at(entry);
-  ret.reserve(data.size());
-  for(const auto & r : data)
+  std::vector<const T *> ret(size(), nullptr);
+  const auto * column = column_at<T>(entry);
+  if(column)
   {
-    ret.push_back(details::record_cast<T>(r));
+    for(size_t i = 0; i < ret.size(); ++i)
+    {
+      if(column->valid[i])
+      {
+        ret[i] = &column->data[i];
+      }
+    }
   }
   return ret;
 }
@@ -75,31 +72,16 @@ std::vector<T> FlatLog::get(const std::string & entry, const T & def) const
     log::error("No entry named {} in the loaded log", entry);
     return {};
   }
-  const auto & data = at(entry);
-  std::vector<T> ret(data.size(), def);
-  for(size_t i = 0; i < data.size(); ++i)
-  {
-    details::convert<T>(data[i], ret[i]);
-  }
-  return ret;
-}
-
-template<>
-inline std::vector<bool> FlatLog::get(const std::string & entry, const bool & def) const
-{
-  if(!has(entry))
+  std::vector<T> ret(size(), def);
+  const auto * column = column_at<T>(entry);
+  if(column)
   {
-    log::error("No entry named {} in the loaded log", entry);
-    return {};
-  }
-  const auto & data = at(entry);
-  std::vector<bool> ret(data.size(), def);
-  for(size_t i = 0; i < data.size(); ++i)
-  {
-    const bool * ptr = details::record_cast<bool>(data[i]);
-    if(ptr)
+    for(size_t i = 0; i < ret.size(); ++i)
     {
-      ret[i] = *ptr;
+      if(column->valid[i])
+      {
+        ret[i] = column->data[i];
+      }
     }
   }
   return ret;
@@ -113,29 +95,27 @@ std::vector<T> FlatLog::get(const std::string & entry) const
     log::error("No entry named {} in the loaded log", entry);
     return {};
   }
-  const auto & data = at(entry);
   std::vector<T> ret;
+  const auto * column = column_at<T>(entry);
   size_t start_i = 0;
-  T def{};
-  while(start_i < data.size())
+  while(column && start_i < size() && !column->valid[start_i])
   {
-    const auto & r = data[start_i];
-    if(details::convert<T>(r, def))
-    {
-      break;
-    }
     start_i++;
   }
-  if(start_i == data.size())
+  if(!column || start_i == size())
   {
     log::error("{} was not logged as the requested data type", entry);
     return ret;
   }
+  T def = column->data[start_i];
   ret.resize(start_i, def);
-  ret.reserve(data.size());
-  for(size_t i = start_i; i < data.size(); ++i)
+  ret.reserve(size());
+  for(size_t i = start_i; i < size(); ++i)
   {
-    details::convert<T>(data[i], def);
+    if(column->valid[i])
+    {
+      def = column->data[i];
+    }
     ret.push_back(def);
   }
   return ret;
@@ -160,13 +140,34 @@ const T * FlatLog::getRaw(const std::string & entry, size_t i) const
     log::error("No entry named {} in the loaded log", entry);
     return nullptr;
   }
-  const auto & data = at(entry);
-  if(i >= data.size())
+  if(i >= size())
   {
-    log::error("Requested data ({}) out of available range ({}, available: {})", entry, i, data.size());
+    log::error("Requested data ({}) out of available range ({}, available: {})", entry, i, size());
     return nullptr;
   }
-  return details::record_cast<T>(data[i]);
+  const auto * column = column_at<T>(entry);
+  if(column && column->valid[i])
+  {
+    return &column->data[i];
+  }
+  return nullptr;
+}
+
+template<typename T>
+auto FlatLog::getSpan(const std::string & entry) const -> span<T>
+{
+  static_assert(!std::is_same_v<T, bool>, "bool entries are not stored contiguously");
+  if(!has(entry))
+  {
+    log::error("No entry named {} in the loaded log", entry);
+    return {};
+  }
+  const auto * column = column_at<T>(entry);
+  if(!column)
+  {
+    return {};
+  }
+  return {column->data.data(), column->data.size()};
 }
 
 } // namespace log
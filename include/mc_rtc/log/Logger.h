@@ -23,6 +23,9 @@ struct LoggerImpl;
  *
  * See mc_rtc::Logger::Policy documentation for details on available
  * policies
+ *
+ * When a log file is closed, an index is written next to it to provide
+ * random access to the log (see mc_rtc::log::BinaryLogReader)
  */
 struct MC_RTC_UTILS_DLLAPI Logger
 {
@@ -34,8 +37,24 @@ public:
    * This is stored in the binary file as data[3] - magic[3]
    */
   static const uint8_t version;
-  /** A function that fills LogData vectors */
-  typedef std::function<void(mc_rtc::MessagePackBuilder &)> serialize_fn;
+  /** Maximum number of frames between two keyframes
+   *
+   * Since version 2, a value that did not change since the previous frame is stored as nil. In a keyframe every value
+   * is stored along with the full key table. A frame is a keyframe if it is the first frame of the file, if the keys
+   * changed, if the previous frame was dropped or if keyframe_period frames were written since the last keyframe.
+   *
+   * Values with a dynamic size (strings and vectors) are compared against a copy that keeps its capacity, the copy only
+   * allocates memory when the value grows beyond its largest size so far (see log::LogPrevious)
+   */
+  static const uint64_t keyframe_period;
+  /** A function that fills LogData vectors
+   *
+   * The boolean is true if the value must be written (keyframe), otherwise nil is written if the value did not change
+   * since the last call
+   */
+  typedef std::function<void(mc_rtc::MessagePackBuilder &, bool)> serialize_fn;
+  /** A function that copies the logged data into its snapshot storage (see log::LogStorage) */
+  typedef std::function<void(void *)> snapshot_fn;
   /*! \brief Defines available policies for the logger */
   enum struct Policy
   {
@@ -54,7 +73,16 @@ public:
      * buffering occurs and you might lose some data if the controller
      * crashes. This is intended for real-time environments.
      */
-    THREADED = 1
+    THREADED = 1,
+    /*! \brief Snapshot policy
+     *
+     * Using this policy, the global controller running thread only copies
+     * the logged values into a pre-allocated snapshot. The serialization and
+     * the disk operations are done in a separate thread. This has the same
+     * caveats as the threaded policy and is intended for real-time
+     * environments with large logs.
+     */
+    SNAPSHOT = 2
   };
 
   /*! \brief Data for a key added event */
@@ -75,6 +103,20 @@ public:
 
   using LogEvent = std::variant<KeyAddedEvent, KeyRemovedEvent>;
 
+  /*! \brief Statistics reported by the logging policy
+   *
+   * These are only meaningful for the Policy::THREADED policy
+   */
+  struct Statistics
+  {
+    /** Number of frames dropped because no buffer was available */
+    uint64_t dropped = 0;
+    /** Maximum number of frames that were waiting to be written at the same time */
+    size_t high_water_mark = 0;
+    /** Number of frames that can wait to be written before data is dropped */
+    size_t capacity = 0;
+  };
+
 public:
   /*! \brief Constructor
    *
@@ -167,10 +209,22 @@ public:
       log::error("Already logging an entry named {}", name);
       return;
     }
+    using storage_t = typename mc_rtc::log::LogCopier<base_t>::storage_t;
     auto log_type = log::callback_is_serializable<CallbackT>::log_type;
     log_events_.push_back(KeyAddedEvent{log_type, name});
-    log_entries_.push_back({log_type, name, source, [get_fn](mc_rtc::MessagePackBuilder & builder) mutable {
-                              mc_rtc::log::LogWriter<base_t>::write(get_fn(), builder);
+    log_entries_.push_back({log_type, name, source,
+                            [get_fn, previous = mc_rtc::log::LogPrevious<base_t>{}](
+                                mc_rtc::MessagePackBuilder & builder, bool keyframe) mutable {
+                              const auto & value = get_fn();
+                              if(previous.update(value) && !keyframe)
+                              {
+                                builder.write();
+                                return;
+                              }
+                              mc_rtc::log::LogWriter<base_t>::write(value, builder);
+                            },
+                            [get_fn](void * storage) mutable {
+                              mc_rtc::log::LogCopier<base_t>::copy(get_fn(), *static_cast<storage_t *>(storage));
                             }});
   }
 
@@ -288,6 +342,9 @@ public:
   /** Flush the log data to disk (only implemented in the synchronous method) */
   void flush();
 
+  /** Returns statistics about the logging policy (drops and buffer usage) */
+  Statistics statistics() const;
+
   /** Returns the number of entries currently in the log */
   inline size_t size() const
   {
@@ -306,6 +363,8 @@ private:
     const void * source;
     /** Callback to log data */
     serialize_fn log_cb;
+    /** Callback to copy data into a snapshot */
+    snapshot_fn snapshot_cb;
   };
   /** Store implementation detail related to the logging policy */
   std::shared_ptr<LoggerImpl> impl_ = nullptr;
@@ -316,6 +375,9 @@ private:
 
   std::vector<LogEntry>::iterator find_entry(const std::string & name);
 
+  /** Implementation of \ref log for Policy::SNAPSHOT */
+  void log_snapshot();
+
   /** Terminal condition for addLogEntries */
   template<typename SourceT>
   void addLogEntries(const SourceT *)
@@ -31,7 +31,8 @@ using binary_log_copy_callback = std::function<bool(const std::vector<std::strin
  * callback has six arguments:
  *
  * - the first are the keys of the entry, note that this is empty if there has
- *   been no change since the previous entry
+ *   been no change since the previous entry (since version 2, the keys are
+ *   also provided at every checkpoint, see BinaryLogReader)
  *
  * - the second is the data corresponding to the keys. The index of a key in
  *   the keys vector give the index for the corresponding data. This index may
@@ -53,7 +54,9 @@ using binary_log_copy_callback = std::function<bool(const std::vector<std::strin
  * \param callback Called for every entry in the log
  *
  * \param extract If true, data is available as their original C++ type, if
- * false, no data is available. Skipping extraction is much faster
+ * false, no data is available. Skipping extraction is much faster for logs
+ * written before version 2, since version 2 the values are always decoded as
+ * unchanged values refer to previous entries
  *
  * \param time Key used as time source. If that key doesn't exist or if it's
  * not a Double record, the parsing will fail. If this parameter is empty, no
@@ -182,6 +182,272 @@ struct LogWriter
   }
 };
 
+/** C++ type used to store a given LogType in a log snapshot
+ *
+ * \see mc_rtc::Logger::Policy::SNAPSHOT
+ */
+template<LogType type>
+struct LogStorage
+{
+  static_assert(type != type, "No storage for this LogType");
+};
+
+#define IMPL_STORAGE(ENUMV, CPPT)   \
+  template<>                        \
+  struct LogStorage<LogType::ENUMV> \
+  {                                 \
+    using type = CPPT;              \
+  }
+
+IMPL_STORAGE(Bool, bool);
+IMPL_STORAGE(Int8_t, int8_t);
+IMPL_STORAGE(Int16_t, int16_t);
+IMPL_STORAGE(Int32_t, int32_t);
+IMPL_STORAGE(Int64_t, int64_t);
+IMPL_STORAGE(Uint8_t, uint8_t);
+IMPL_STORAGE(Uint16_t, uint16_t);
+IMPL_STORAGE(Uint32_t, uint32_t);
+IMPL_STORAGE(Uint64_t, uint64_t);
+IMPL_STORAGE(Float, float);
+IMPL_STORAGE(Double, double);
+IMPL_STORAGE(String, std::string);
+IMPL_STORAGE(Vector2d, Eigen::Vector2d);
+IMPL_STORAGE(Vector3d, Eigen::Vector3d);
+IMPL_STORAGE(Vector6d, Eigen::Vector6d);
+IMPL_STORAGE(VectorXd, Eigen::VectorXd);
+IMPL_STORAGE(Quaterniond, Eigen::Quaterniond);
+IMPL_STORAGE(PTransformd, sva::PTransformd);
+IMPL_STORAGE(ForceVecd, sva::ForceVecd);
+IMPL_STORAGE(MotionVecd, sva::MotionVecd);
+IMPL_STORAGE(VectorDouble, std::vector<double>);
+
+#undef IMPL_STORAGE
+
+/** For a given type, copy the data into its snapshot storage
+ *
+ * Once the storage has been used the copy does not allocate memory unless the data grows
+ */
+template<typename T>
+struct LogCopier
+{
+  using storage_t = typename LogStorage<GetLogType<T>::type>::type;
+
+  static void copy(const T & data, storage_t & out)
+  {
+    out = data;
+  }
+};
+
+template<>
+struct LogCopier<sva::ImpedanceVecd>
+{
+  using storage_t = sva::MotionVecd;
+
+  static void copy(const sva::ImpedanceVecd & data, storage_t & out)
+  {
+    out.angular() = data.angular();
+    out.linear() = data.linear();
+  }
+};
+
+template<typename A>
+struct LogCopier<std::vector<double, A>>
+{
+  using storage_t = std::vector<double>;
+
+  static void copy(const std::vector<double, A> & data, storage_t & out)
+  {
+    out.assign(data.begin(), data.end());
+  }
+};
+
+template<std::size_t N>
+struct LogCopier<std::array<double, N>>
+{
+  using storage_t = std::vector<double>;
+
+  static void copy(const std::array<double, N> & data, storage_t & out)
+  {
+    out.assign(data.begin(), data.end());
+  }
+};
+
+/** True if the storage for a given type never allocates memory */
+template<typename T>
+struct storage_is_static : public std::true_type
+{
+};
+
+template<>
+struct storage_is_static<std::string> : public std::false_type
+{
+};
+
+template<>
+struct storage_is_static<Eigen::VectorXd> : public std::false_type
+{
+};
+
+template<typename A>
+struct storage_is_static<std::vector<double, A>> : public std::false_type
+{
+};
+
+/** @name Compare data stored in a snapshot
+ *
+ * These are used to detect entries that did not change from one frame to the next
+ *
+ * @{
+ */
+
+template<typename T>
+bool storage_equal(const T & lhs, const T & rhs)
+{
+  return lhs == rhs;
+}
+
+inline bool storage_equal(const Eigen::VectorXd & lhs, const Eigen::VectorXd & rhs)
+{
+  return lhs.size() == rhs.size() && lhs == rhs;
+}
+
+inline bool storage_equal(const Eigen::Quaterniond & lhs, const Eigen::Quaterniond & rhs)
+{
+  return lhs.coeffs() == rhs.coeffs();
+}
+
+inline bool storage_equal(const sva::PTransformd & lhs, const sva::PTransformd & rhs)
+{
+  return lhs.rotation() == rhs.rotation() && lhs.translation() == rhs.translation();
+}
+
+inline bool storage_equal(const sva::ForceVecd & lhs, const sva::ForceVecd & rhs)
+{
+  return lhs.couple() == rhs.couple() && lhs.force() == rhs.force();
+}
+
+inline bool storage_equal(const sva::MotionVecd & lhs, const sva::MotionVecd & rhs)
+{
+  return lhs.angular() == rhs.angular() && lhs.linear() == rhs.linear();
+}
+
+/** @} */
+
+/** Initial value of a stored entry, fixed-size Eigen and SpaceVecAlg types are not initialized by their default
+ * constructor */
+template<typename T>
+T storage_init()
+{
+  if constexpr(std::is_base_of_v<Eigen::DenseBase<T>, T>)
+  {
+    if constexpr(T::SizeAtCompileTime != Eigen::Dynamic)
+    {
+      return T::Zero();
+    }
+    else
+    {
+      return T{};
+    }
+  }
+  else if constexpr(std::is_same_v<T, Eigen::Quaterniond> || std::is_same_v<T, sva::PTransformd>)
+  {
+    return T::Identity();
+  }
+  else if constexpr(std::is_same_v<T, sva::ForceVecd> || std::is_same_v<T, sva::MotionVecd>)
+  {
+    return T::Zero();
+  }
+  else
+  {
+    return T{};
+  }
+}
+
+/** Keep the previous value of a log entry to detect values that did not change
+ *
+ * Fixed-size values are copied into their storage type (see LogCopier)
+ */
+template<typename T, bool Static = storage_is_static<typename LogCopier<T>::storage_t>::value>
+struct LogPrevious
+{
+  using storage_t = typename LogCopier<T>::storage_t;
+
+  /** Returns true if \p value is equal to the previous value, otherwise \p value becomes the previous value */
+  bool update(const T & value)
+  {
+    LogCopier<T>::copy(value, current_);
+    if(valid_ && storage_equal(current_, previous_))
+    {
+      return true;
+    }
+    std::swap(current_, previous_);
+    valid_ = true;
+    return false;
+  }
+
+private:
+  storage_t current_ = storage_init<storage_t>();
+  storage_t previous_ = storage_init<storage_t>();
+  bool valid_ = false;
+};
+
+/** Values with a dynamic size are compared against a buffer that keeps its capacity
+ *
+ * The buffer only allocates memory when the value grows beyond its largest size so far
+ */
+template<typename T>
+struct LogPrevious<T, false>
+{
+  bool update(const T & value)
+  {
+    if constexpr(std::is_same_v<T, std::string>)
+    {
+      if(valid_ && previous_ == value)
+      {
+        return true;
+      }
+      previous_.assign(value);
+    }
+    else
+    {
+      size_t size = static_cast<size_t>(value.size());
+      bool same = valid_ && previous_.size() == size;
+      for(size_t i = 0; same && i < size; ++i)
+      {
+        same = previous_[i] == at(value, i);
+      }
+      if(same)
+      {
+        return true;
+      }
+      previous_.resize(size);
+      for(size_t i = 0; i < size; ++i)
+      {
+        previous_[i] = at(value, i);
+      }
+    }
+    valid_ = true;
+    return false;
+  }
+
+private:
+  std::conditional_t<std::is_same_v<T, std::string>, std::string, std::vector<double>> previous_;
+  bool valid_ = false;
+
+  template<typename U>
+  static double at(const U & value, size_t i)
+  {
+    if constexpr(std::is_base_of_v<Eigen::DenseBase<U>, U>)
+    {
+      return value(static_cast<Eigen::DenseIndex>(i));
+    }
+    else
+    {
+      return value[i];
+    }
+  }
+};
+
 } // namespace log
 
 } // namespace mc_rtc
@@ -8,6 +8,7 @@
 
 #include <mc_rbdyn/Collision.h>
 
+#include <mc_rtc/WorkerPool.h>
 #include <mc_rtc/gui/StateBuilder.h>
 #include <mc_rtc/void_ptr.h>
 
@@ -28,6 +29,9 @@ public:
   /** Default value of damping offset */
   constexpr static double defaultDampingOffset = 0.1;
 
+  /** Default value of the culling margin */
+  constexpr static double defaultCullingMargin = 0.05;
+
 public:
   /** Constructor
    *
@@ -86,6 +90,46 @@ public:
   /** Remove all collisions from the constraint */
   void reset();
 
+  /** Set the margin used to skip the exact distance computation of distant pairs
+   *
+   * If the bounding spheres of a pair are further apart than the pair's interaction distance plus this margin, the
+   * pair cannot be active and its exact distance (GJK) is not computed. A negative margin disables this check.
+   *
+   * The distance and closest points reported for a culled pair (see mc_tvm::CollisionFunction::culled) are a lower
+   * bound of the distance and the closest points of the bounding spheres.
+   *
+   * \note This is only implemented in the TVM backend, the Tasks backend always computes the exact distance and
+   * setting a margin has no effect (a warning is displayed)
+   */
+  void cullingMargin(double margin);
+
+  /** Margin used to skip the exact distance computation of distant pairs */
+  inline double cullingMargin() const noexcept
+  {
+    return cullingMargin_;
+  }
+
+  /** Evaluate the collision pairs on a pool of worker threads before every solve
+   *
+   * The distance and Jacobian of every pair are computed by the workers and the solver thread, each pair writes its
+   * own results so they do not depend on the number of threads. With 0 threads (default), the pairs are evaluated
+   * sequentially by the solver.
+   *
+   * \param threads Number of worker threads
+   *
+   * \param cpus CPUs the workers are pinned to, see mc_rtc::WorkerPool
+   *
+   * \param spin Time the workers and the solver thread spin before sleeping, see mc_rtc::WorkerPool
+   *
+   * \note This is only implemented in the TVM backend
+   */
+  void parallel(size_t threads,
+                const std::vector<int> & cpus = {},
+                std::chrono::microseconds spin = mc_rtc::WorkerPool::default_spin);
+
+  /** Number of worker threads used to evaluate the collision pairs */
+  size_t parallel() const noexcept;
+
   void addToSolverImpl(QPSolver & solver) override;
 
   void removeFromSolverImpl(QPSolver & solver) override;
@@ -109,6 +153,7 @@ public:
 
 private:
   /* Internal sauce to manage collisions */
+  double cullingMargin_ = defaultCullingMargin;
   int collId;
   std::map<std::string, std::pair<int, mc_rbdyn::Collision>> collIdDict;
   std::string __keyByNames(const std::string & name1, const std::string & name2);
@@ -12,6 +12,8 @@
 #include <tvm/LinearizedControlProblem.h>
 #include <tvm/scheme/WeightedLeastSquares.h>
 
+#include <functional>
+
 namespace mc_solver
 {
 
@@ -36,6 +38,17 @@ struct MC_SOLVER_DLLAPI TVMQPSolver final : public QPSolver
 
   double solveAndBuildTime() final;
 
+  /** Register a callback that is called before every solve
+   *
+   * \param owner Identifies the callback for \ref removePreSolveCallback
+   *
+   * \param callback Called before the problem is solved, the robots' configurations are up-to-date
+   */
+  void addPreSolveCallback(const void * owner, std::function<void()> callback);
+
+  /** Remove the callbacks registered by \p owner */
+  void removePreSolveCallback(const void * owner);
+
   /** Access the internal problem */
   inline tvm::LinearizedControlProblem & problem() noexcept
   {
@@ -95,6 +108,8 @@ private:
   std::vector<ContactData> contactsData_;
   /** Runtime of the latest run call */
   mc_rtc::duration_ms solve_dt_{0};
+  /** Callbacks called before every solve */
+  std::vector<std::pair<const void *, std::function<void()>>> preSolve_;
 
   /** Common part of control loop */
   bool runCommon();
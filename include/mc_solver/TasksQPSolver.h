@@ -202,6 +202,9 @@ private:
    */
   bool runClosedLoop(bool integrateControlState);
 
+  /** Solve the QP without updating the robots */
+  bool solve();
+
   /** Feedback data */
   std::vector<std::vector<double>> prev_encoders_{};
   std::vector<std::vector<double>> encoders_alpha_{};
@@ -40,10 +40,64 @@ public:
                     const Eigen::VectorXd & r2Selector,
                     double dt);
 
-  /** Called *once* every iteration to advance the iteration counter */
+  /** Called *once* every iteration to advance the iteration counter
+   *
+   * This also discards the results of \ref precompute that were not used by the computation graph
+   */
   void tick();
 
-  /** Distance between the two objects */
+  /** Distance above which the exact distance computation is skipped
+   *
+   * Before the exact distance is computed, the distance between the bounding spheres of the two convexes is compared
+   * to this value. If it is greater, this distance (a lower bound of the distance between the convexes) is used as the
+   * function value and the closest points are taken on the bounding spheres.
+   *
+   * A negative value (default) disables the check
+   */
+  inline void cullingDistance(double d) noexcept
+  {
+    cullingDistance_ = d;
+  }
+
+  /** Distance above which the exact distance computation is skipped */
+  inline double cullingDistance() const noexcept
+  {
+    return cullingDistance_;
+  }
+
+  /** Compute the value and the Jacobian outside of the computation graph
+   *
+   * The next value and Jacobian updates use the results of this computation. This is meant to evaluate several
+   * collision functions in parallel before the problem is solved, in that case:
+   * - the positions of the convexes must be updated beforehand (see Convex::update)
+   * - two collision functions can be computed concurrently, even if they share a convex or a frame: the computation
+   *   reads the frames' positions from the convexes (Convex::framePosition) and does not touch the RobotFrame caches
+   */
+  void precompute();
+
+  /** Discard the results of \ref precompute that were not used by the computation graph yet
+   *
+   * The next value and Jacobian updates compute them again
+   */
+  inline void discardPrecomputed() noexcept
+  {
+    valueReady_ = false;
+    jacobianReady_ = false;
+  }
+
+  /** True if the exact distance computation was skipped in the last update
+   *
+   * The Jacobian, velocity and normal acceleration of a culled pair are zero
+   */
+  inline bool culled() const noexcept
+  {
+    return culled_;
+  }
+
+  /** Distance between the two objects
+   *
+   * If the pair is \ref culled this is a lower bound of the distance: the distance between the bounding spheres
+   */
   inline double distance() const noexcept
   {
     return this->value()(0);
@@ -55,7 +109,7 @@ public:
     return *c1_;
   }
 
-  /** Closest point on c1 in inertial frame coordinates */
+  /** Closest point on c1 in inertial frame coordinates, on the bounding sphere of c1 if the pair is \ref culled */
   inline const Eigen::Vector3d & p1() const noexcept
   {
     return p1_;
@@ -67,7 +121,7 @@ public:
     return *c2_;
   }
 
-  /** Closest point on c2 in inertial frame coordinates */
+  /** Closest point on c2 in inertial frame coordinates, on the bounding sphere of c2 if the pair is \ref culled */
   inline const Eigen::Vector3d & p2() const noexcept
   {
     return p2_;
@@ -80,6 +134,9 @@ protected:
   void updateJacobian();
   void updateNormalAcceleration();
 
+  void computeValue();
+  void computeJacobian();
+
   uint64_t iter_ = 0;
   uint64_t prevIter_ = 0;
 
@@ -87,6 +144,12 @@ protected:
   Convex * c2_;
   double dt_;
 
+  double cullingDistance_ = -1.0;
+  bool culled_ = false;
+  /** True if the value (resp. Jacobian) has been computed by \ref precompute and not used by an update yet */
+  bool valueReady_ = false;
+  bool jacobianReady_ = false;
+
   Eigen::Vector3d p1_ = Eigen::Vector3d::Zero();
   Eigen::Vector3d p2_ = Eigen::Vector3d::Zero();
 
@@ -19,6 +19,8 @@ namespace mc_tvm
  *
  * It defines a single output:
  * - Position: update the convex position according to the frame
+ *
+ * A sphere bounding the convex is computed once when the convex is created, its center follows the convex
  */
 struct MC_TVM_DLLAPI Convex : public tvm::graph::abstract::Node<Convex>
 {
@@ -61,10 +63,48 @@ public:
     return *frame_;
   }
 
+  /** Update the convex position from its frame outside of the computation graph
+   *
+   * This does nothing if the convex was already updated since the robot kinematics last changed (see
+   * mc_rbdyn::Robot::kinematicsGeneration), the update in the computation graph is skipped in the same way
+   */
+  void update();
+
+  /** Position of the frame when the convex position was last updated
+   *
+   * Unlike frame().position() this only reads the convex so it can be used concurrently once the convex is updated
+   */
+  inline const sva::PTransformd & framePosition() const noexcept
+  {
+    return X_0_f_;
+  }
+
+  /** Center of the bounding sphere in world coordinates */
+  inline const Eigen::Vector3d & boundingCenter() const noexcept
+  {
+    return center_;
+  }
+
+  /** Radius of the bounding sphere */
+  inline double boundingRadius() const noexcept
+  {
+    return radius_;
+  }
+
 private:
   mc_rbdyn::S_ObjectPtr object_;
   mc_rbdyn::ConstRobotFramePtr frame_;
   sva::PTransformd X_f_c_;
+  /** Position of the frame in world coordinates, see framePosition() */
+  sva::PTransformd X_0_f_ = sva::PTransformd::Identity();
+  /** Center of the bounding sphere in the convex frame */
+  Eigen::Vector3d localCenter_ = Eigen::Vector3d::Zero();
+  /** Center of the bounding sphere in world coordinates */
+  Eigen::Vector3d center_ = Eigen::Vector3d::Zero();
+  /** Radius of the bounding sphere */
+  double radius_ = 0.0;
+  /** Kinematics generation of the robot when the convex was last updated */
+  uint64_t generation_ = 0;
 
   void updatePosition();
 };
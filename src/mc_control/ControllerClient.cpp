@@ -285,18 +285,42 @@ void ControllerClient::handle_gui_state(mc_rtc::Configuration state)
     stopped();
     return;
   }
-  started();
   int version = state[0];
-  if(version > mc_rtc::gui::StateBuilder::PROTOCOL_VERSION)
+  if(version > mc_rtc::gui::StateBuilder::DELTA_PROTOCOL_VERSION)
   {
+    started();
     mc_rtc::log::error("Receive message, version: {} but I can only handle version {} and lower", version,
-                       mc_rtc::gui::StateBuilder::PROTOCOL_VERSION);
+                       mc_rtc::gui::StateBuilder::DELTA_PROTOCOL_VERSION);
     handle_category({}, "", {});
     stopped();
     return;
   }
-  data_ = state[1];
-  handle_category({}, "", state[2]);
+  std::unordered_map<size_t, mc_rtc::Configuration> changes;
+  if(state.size() > 5)
+  {
+    // Partial state, only the elements that changed since the full state are provided
+    uint64_t id = state[4];
+    if(id != full_state_id_)
+    {
+      // Missed the full state, wait for the next one
+      return;
+    }
+    auto changes_data = state[5];
+    for(size_t i = 0; i < changes_data.size(); ++i)
+    {
+      uint64_t idx = changes_data[i][0];
+      changes[idx] = changes_data[i][1];
+    }
+  }
+  else
+  {
+    data_ = state[1];
+    full_state_ = state[2];
+    full_state_id_ = state.size() > 4 ? static_cast<uint64_t>(state[4]) : 0;
+  }
+  started();
+  size_t idx = 0;
+  handle_category({}, "", full_state_, changes, idx);
   if(3 < state.size())
   {
     auto plots = state[3];
@@ -311,6 +335,16 @@ void ControllerClient::handle_gui_state(mc_rtc::Configuration state)
 void ControllerClient::handle_category(const std::vector<std::string> & parent,
                                        const std::string & category,
                                        const mc_rtc::Configuration & data)
+{
+  size_t idx = 0;
+  handle_category(parent, category, data, {}, idx);
+}
+
+void ControllerClient::handle_category(const std::vector<std::string> & parent,
+                                       const std::string & category,
+                                       const mc_rtc::Configuration & data,
+                                       const std::unordered_map<size_t, mc_rtc::Configuration> & changes,
+                                       size_t & idx)
 {
   if(data.size() < 2)
   {
@@ -325,9 +359,10 @@ void ControllerClient::handle_category(const std::vector<std::string> & parent,
   {
     next_category.push_back(category);
   }
-  for(size_t i = 1; i < data.size() - 1; ++i)
+  for(size_t i = 1; i < data.size() - 1; ++i, ++idx)
   {
-    auto widget_data = data[i];
+    auto change = changes.find(idx);
+    auto widget_data = change != changes.end() ? change->second : data[i];
     std::string widget_name = widget_data[0];
     int sid = widget_data.at(2, -1);
     handle_widget({next_category, widget_name, sid}, widget_data);
@@ -337,7 +372,7 @@ void ControllerClient::handle_category(const std::vector<std::string> & parent,
     auto cat_data = data[data.size() - 1];
     for(size_t i = 0; i < cat_data.size(); ++i)
     {
-      handle_category(next_category, cat_data[i][0], cat_data[i]);
+      handle_category(next_category, cat_data[i][0], cat_data[i], changes, idx);
     }
   }
 }
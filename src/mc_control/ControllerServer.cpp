@@ -4,6 +4,8 @@
 
 #include <mc_control/ControllerServer.h>
 
+#include <mc_rtc/Tracing.h>
+
 #ifndef MC_RTC_DISABLE_NETWORK
 #  include <nanomsg/nn.h>
 #  include <nanomsg/pipeline.h>
@@ -21,6 +23,7 @@ ControllerServer::ControllerServer(double dt,
 {
   iter_ = 0;
   rate_ = static_cast<unsigned int>(ceil(server_dt / dt));
+  dt_ = dt;
 #ifndef MC_RTC_DISABLE_NETWORK
   auto init_socket = [](int & socket, int proto, const std::vector<std::string> & uris, const std::string & name) {
     socket = nn_socket(AF_SP, proto);
@@ -44,6 +47,7 @@ ControllerServer::ControllerServer(double dt,
 
 ControllerServer::~ControllerServer()
 {
+  async(false);
 #ifndef MC_RTC_DISABLE_NETWORK
   nn_close(pub_socket_);
   nn_close(pull_socket_);
@@ -52,13 +56,16 @@ ControllerServer::~ControllerServer()
 
 void ControllerServer::handle_requests(mc_rtc::gui::StateBuilder & gui_builder, const char * dataIn)
 {
-  auto config = mc_rtc::Configuration::fromData(static_cast<const char *>(dataIn));
-  auto category = config("category", std::vector<std::string>{});
-  auto name = config("name", std::string{});
-  auto data = config("data", mc_rtc::Configuration{});
-  if(!gui_builder.handleRequest(category, name, data))
+  // The request is only read here so it is parsed in a scratch document, only its data is copied
+  mc_rtc::Configuration::ScratchData request(dataIn);
+  std::vector<std::string> category;
+  request.read("category", category);
+  std::string name;
+  request.read("name", name);
+  if(!gui_builder.handleRequest(category, name, request.copy("data")))
   {
-    mc_rtc::log::error("Invokation of the following method failed\n{}\n", config.dump(true));
+    mc_rtc::log::error("Invokation of the following method failed\n{}\n",
+                       mc_rtc::Configuration::fromData(dataIn).dump(true));
   }
 }
 
@@ -90,9 +97,47 @@ void ControllerServer::handle_requests(mc_rtc::gui::StateBuilder & gui_builder)
 
 void ControllerServer::publish(mc_rtc::gui::StateBuilder & gui_builder)
 {
+  if(async_)
+  {
+    // Expose the latest message sent by the server thread in data(), the buffers are exchanged without copy
+    buffer_size_ = 0;
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if(lock.owns_lock() && has_published_)
+    {
+      std::swap(buffer_, published_);
+      buffer_size_ = published_size_;
+      has_published_ = false;
+    }
+  }
   if(iter_++ % rate_ == 0)
   {
-    buffer_size_ = gui_builder.update(buffer_);
+    if(async_)
+    {
+      gui_builder.capture(capture_);
+      bool full = delta_ && snapshot_iter_++ % snapshot_rate_ == 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if(has_pending_)
+        {
+          // The previous snapshot was not sent, keep its requirements
+          capture_.reset = capture_.reset || pending_.reset;
+          full = full || pending_full_;
+        }
+        std::swap(capture_, pending_);
+        has_pending_ = true;
+        pending_full_ = full;
+      }
+      cv_.notify_one();
+      return;
+    }
+    if(delta_)
+    {
+      buffer_size_ = gui_builder.updateDelta(buffer_, snapshot_iter_++ % snapshot_rate_ == 0);
+    }
+    else
+    {
+      buffer_size_ = gui_builder.update(buffer_);
+    }
 #ifndef MC_RTC_DISABLE_NETWORK
     nn_send(pub_socket_, buffer_.data(), buffer_size_, 0);
 #endif
@@ -100,10 +145,77 @@ void ControllerServer::publish(mc_rtc::gui::StateBuilder & gui_builder)
   else
   {
     gui_builder.update();
+    if(!async_)
+    {
+      buffer_size_ = 0;
+    }
+  }
+}
+
+void ControllerServer::delta(bool enable, double snapshot_period)
+{
+  delta_ = enable;
+  snapshot_rate_ = std::max(static_cast<unsigned int>(ceil(snapshot_period / (rate_ * dt_))), 1u);
+  snapshot_iter_ = 0;
+}
+
+void ControllerServer::async(bool enable)
+{
+  if(enable == async_)
+  {
+    return;
+  }
+  if(enable)
+  {
+    async_ = true;
+    running_ = true;
+    thread_ = std::thread([this]() { run(); });
+  }
+  else
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      running_ = false;
+    }
+    cv_.notify_one();
+    thread_.join();
+    async_ = false;
+    has_pending_ = false;
+    has_published_ = false;
     buffer_size_ = 0;
   }
 }
 
+void ControllerServer::run()
+{
+#ifdef MC_RTC_ENABLE_TRACING
+  mc_rtc::trace::threadName("GUI server");
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  while(true)
+  {
+    cv_.wait(lock, [this]() { return has_pending_ || !running_; });
+    if(!running_)
+    {
+      return;
+    }
+    std::swap(pending_, sending_);
+    bool full = pending_full_;
+    has_pending_ = false;
+    lock.unlock();
+    async_buffer_size_ =
+        delta_ ? encoder_.updateDelta(sending_, async_buffer_, full) : encoder_.update(sending_, async_buffer_);
+#ifndef MC_RTC_DISABLE_NETWORK
+    nn_send(pub_socket_, async_buffer_.data(), async_buffer_size_, 0);
+#endif
+    lock.lock();
+    // Hand over the message to data(), a message that was not picked up yet is replaced
+    std::swap(async_buffer_, published_);
+    published_size_ = async_buffer_size_;
+    has_published_ = true;
+  }
+}
+
 std::pair<const char *, size_t> ControllerServer::data() const
 {
   return {buffer_.data(), buffer_size_};
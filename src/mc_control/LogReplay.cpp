@@ -0,0 +1,338 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/LogReplay.h>
+
+#include <mc_rtc/clock.h>
+#include <mc_rtc/log/iterate_binary_log.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mc_control
+{
+
+namespace
+{
+
+using LogType = mc_rtc::log::LogType;
+using record = mc_rtc::log::FlatLog::record;
+
+/** Index of a log entry in the current keys, -1 if it is not in the log */
+struct Entry
+{
+  std::string name;
+  int index = -1;
+
+  void resolve(const std::vector<std::string> & keys)
+  {
+    auto it = std::find(keys.begin(), keys.end(), name);
+    index = it == keys.end() ? -1 : static_cast<int>(std::distance(keys.begin(), it));
+  }
+
+  template<typename T>
+  const T * get(const std::vector<record> & records, LogType type) const
+  {
+    if(index < 0 || static_cast<size_t>(index) >= records.size())
+    {
+      return nullptr;
+    }
+    const auto & r = records[static_cast<size_t>(index)];
+    if(r.type != type || !r.data)
+    {
+      return nullptr;
+    }
+    return static_cast<const T *>(r.data.get());
+  }
+};
+
+/** Readings of named sensors, Map is the type expected by MCGlobalController */
+template<typename T, typename Map = std::map<std::string, T>>
+struct SensorEntries
+{
+  /** Log entry and value of each sensor */
+  std::vector<std::pair<Entry, typename Map::iterator>> entries;
+  Map values;
+
+  /** \p value is used until the sensor is found in the log */
+  void add(const std::string & sensor, const std::string & entry, const T & value)
+  {
+    entries.push_back({{entry}, values.emplace(sensor, value).first});
+  }
+
+  void resolve(const std::vector<std::string> & keys)
+  {
+    for(auto & e : entries)
+    {
+      e.first.resolve(keys);
+    }
+  }
+
+  /** Update values from the records, returns false if no value was found */
+  bool update(const std::vector<record> & records, LogType type)
+  {
+    bool found = false;
+    for(auto & e : entries)
+    {
+      const T * value = e.first.template get<T>(records, type);
+      if(value)
+      {
+        e.second->second = *value;
+        found = true;
+      }
+    }
+    return found;
+  }
+};
+
+} // namespace
+
+mc_rtc::Configuration LogReplayReport::save() const
+{
+  mc_rtc::Configuration out;
+  out.add("log", log);
+  out.add("controller", controller);
+  out.add("success", success);
+  out.add("ticks", ticks);
+  out.add("warmup", warmup);
+  out.add("timestep", timestep);
+  out.add("run_time", run_time);
+  out.add("realtime_factor", realtime_factor);
+  out.add("latency", latency);
+  auto determinism = out.add("determinism");
+  determinism.add("deterministic", deterministic());
+  determinism.add("tolerance", tolerance);
+  determinism.add("diverged_ticks", diverged_ticks);
+  determinism.add("first_divergence", first_divergence);
+  auto errors = determinism.add("max_error");
+  for(const auto & e : max_error)
+  {
+    errors.add(e.first, e.second);
+  }
+  return out;
+}
+
+LogReplayReport replayLog(MCGlobalController & gc, const std::string & log, const LogReplayOptions & options)
+{
+  LogReplayReport report;
+  report.log = log;
+  report.controller = gc.current_controller();
+  report.warmup = options.warmup;
+  report.timestep = gc.timestep();
+  report.tolerance = options.tolerance;
+
+  // Logged state of the main robot, see MCController::addRobotToLog
+  const auto & robot = gc.controller().robot();
+  // Sensors entries, see MCController::addRobotToLog
+  Entry qIn{"qIn"};
+  Entry alphaIn{"alphaIn"};
+  Entry tauIn{"tauIn"};
+  SensorEntries<sva::ForceVecd> wrenches;
+  for(const auto & fs : robot.forceSensors())
+  {
+    wrenches.add(fs.name(), fs.name(), fs.wrench());
+  }
+  SensorEntries<Eigen::Vector3d> positions;
+  SensorEntries<Eigen::Quaterniond, MCGlobalController::QuaternionMap> orientations;
+  SensorEntries<Eigen::Vector3d> linearVelocities;
+  SensorEntries<Eigen::Vector3d> angularVelocities;
+  SensorEntries<Eigen::Vector3d> linearAccelerations;
+  SensorEntries<Eigen::Vector3d> angularAccelerations;
+  for(const auto & bs : robot.bodySensors())
+  {
+    const auto & name = bs.name();
+    positions.add(name, name + "_position", bs.position());
+    orientations.add(name, name + "_orientation", bs.orientation());
+    linearVelocities.add(name, name + "_linearVelocity", bs.linearVelocity());
+    angularVelocities.add(name, name + "_angularVelocity", bs.angularVelocity());
+    linearAccelerations.add(name, name + "_linearAcceleration", bs.linearAcceleration());
+    angularAccelerations.add(name, name + "_angularAcceleration", bs.angularAcceleration());
+  }
+  // Outputs
+  Entry qOut{"qOut"};
+  Entry alphaOut{"alphaOut"};
+  Entry tauOut{"tauOut"};
+  Entry ff{"ff"};
+
+  bool initialized = false;
+  bool failed = false;
+  double run_time = 0;
+
+  auto maxError = [&](const std::string & name, double error) {
+    auto & e = report.max_error[name];
+    e = std::max(e, error);
+    return error > options.tolerance;
+  };
+  /** Compare a joint-space output against its log, member is a pointer to the corresponding mbc member */
+  auto compareJoints = [&](const Entry & entry, const std::vector<record> & records,
+                           std::vector<std::vector<double>> rbd::MultiBodyConfig::*member) {
+    const auto * logged = entry.get<std::vector<double>>(records, LogType::VectorDouble);
+    if(!logged)
+    {
+      return false;
+    }
+    const auto & robot = gc.controller().robot();
+    const auto & values = robot.mbc().*member;
+    double error = 0;
+    for(size_t i = 0; i < std::min(logged->size(), robot.refJointOrder().size()); ++i)
+    {
+      auto mbcIndex = robot.jointIndexInMBC(i);
+      if(mbcIndex != -1)
+      {
+        error = std::max(error, std::abs(values[static_cast<size_t>(mbcIndex)][0] - (*logged)[i]));
+      }
+    }
+    return maxError(entry.name, error);
+  };
+
+  auto callback = [&](const std::vector<std::string> & keys, const std::vector<record> & records, double) {
+    if(options.max_ticks != 0 && report.ticks >= options.max_ticks)
+    {
+      return false;
+    }
+    if(keys.size())
+    {
+      for(auto * e : {&qIn, &alphaIn, &tauIn, &qOut, &alphaOut, &tauOut, &ff})
+      {
+        e->resolve(keys);
+      }
+      wrenches.resolve(keys);
+      positions.resolve(keys);
+      orientations.resolve(keys);
+      linearVelocities.resolve(keys);
+      angularVelocities.resolve(keys);
+      linearAccelerations.resolve(keys);
+      angularAccelerations.resolve(keys);
+    }
+    // Feed the sensors
+    const auto * q = qIn.get<std::vector<double>>(records, LogType::VectorDouble);
+    if(q)
+    {
+      gc.setEncoderValues(*q);
+    }
+    const auto * alpha = alphaIn.get<std::vector<double>>(records, LogType::VectorDouble);
+    if(alpha)
+    {
+      gc.setEncoderVelocities(*alpha);
+    }
+    const auto * tau = tauIn.get<std::vector<double>>(records, LogType::VectorDouble);
+    if(tau)
+    {
+      gc.setJointTorques(*tau);
+    }
+    if(wrenches.update(records, LogType::ForceVecd))
+    {
+      gc.setWrenches(wrenches.values);
+    }
+    if(positions.update(records, LogType::Vector3d))
+    {
+      gc.setSensorPositions(positions.values);
+    }
+    if(orientations.update(records, LogType::Quaterniond))
+    {
+      gc.setSensorOrientations(orientations.values);
+    }
+    if(linearVelocities.update(records, LogType::Vector3d))
+    {
+      gc.setSensorLinearVelocities(linearVelocities.values);
+    }
+    if(angularVelocities.update(records, LogType::Vector3d))
+    {
+      gc.setSensorAngularVelocities(angularVelocities.values);
+    }
+    if(linearAccelerations.update(records, LogType::Vector3d))
+    {
+      gc.setSensorLinearAccelerations(linearAccelerations.values);
+    }
+    if(angularAccelerations.update(records, LogType::Vector3d))
+    {
+      gc.setSensorAngularAccelerations(angularAccelerations.values);
+    }
+    if(!initialized)
+    {
+      std::vector<double> initq;
+      if(q)
+      {
+        initq = *q;
+      }
+      else
+      {
+        const auto & robot = gc.controller().robot();
+        for(size_t i = 0; i < robot.refJointOrder().size(); ++i)
+        {
+          auto mbcIndex = robot.jointIndexInMBC(i);
+          initq.push_back(mbcIndex != -1 ? robot.mbc().q[static_cast<size_t>(mbcIndex)][0] : 0.0);
+        }
+      }
+      const auto * attitude = ff.get<sva::PTransformd>(records, LogType::PTransformd);
+      if(attitude)
+      {
+        gc.init(initq, *attitude);
+      }
+      else
+      {
+        gc.init(initq);
+      }
+      gc.running = true;
+      initialized = true;
+    }
+    if(report.ticks == options.warmup)
+    {
+      gc.resetLatencyStatistics();
+    }
+    auto start_t = mc_rtc::clock::now();
+    bool r = gc.run();
+    if(report.ticks >= options.warmup)
+    {
+      run_time += mc_rtc::duration_ms(mc_rtc::clock::now() - start_t).count() / 1000.0;
+    }
+    if(!r)
+    {
+      mc_rtc::log::error("[replayLog] Controller failed at tick {}", report.ticks);
+      failed = true;
+      return false;
+    }
+    // Compare the outputs
+    bool diverged = compareJoints(qOut, records, &rbd::MultiBodyConfig::q);
+    diverged = compareJoints(alphaOut, records, &rbd::MultiBodyConfig::alpha) || diverged;
+    diverged = compareJoints(tauOut, records, &rbd::MultiBodyConfig::jointTorque) || diverged;
+    const auto * pos = ff.get<sva::PTransformd>(records, LogType::PTransformd);
+    if(pos)
+    {
+      const auto & posW = gc.controller().robot().mbc().bodyPosW[0];
+      double error = std::max((posW.translation() - pos->translation()).cwiseAbs().maxCoeff(),
+                              (posW.rotation() - pos->rotation()).cwiseAbs().maxCoeff());
+      diverged = maxError(ff.name, error) || diverged;
+    }
+    if(diverged)
+    {
+      if(report.first_divergence < 0)
+      {
+        report.first_divergence = static_cast<int64_t>(report.ticks);
+      }
+      report.diverged_ticks++;
+    }
+    report.ticks++;
+    return true;
+  };
+  bool ok = mc_rtc::log::iterate_binary_log(log, callback, true);
+  // The iteration is also interrupted when max_ticks is reached
+  bool complete = ok || (options.max_ticks != 0 && report.ticks == options.max_ticks);
+  report.success = complete && !failed && report.ticks != 0;
+  if(!report.success)
+  {
+    mc_rtc::log::error("[replayLog] Failed to replay {}", log);
+  }
+  report.run_time = run_time;
+  if(run_time > 0 && report.ticks > report.warmup)
+  {
+    report.realtime_factor = static_cast<double>(report.ticks - report.warmup) * report.timestep / run_time;
+  }
+  report.latency = gc.latencyStatistics();
+  // The period includes the time spent reading the log
+  report.latency.remove("Period");
+  return report;
+}
+
+} // namespace mc_control
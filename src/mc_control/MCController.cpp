@@ -376,10 +376,17 @@ mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm, const std
       }
     }
   }
+  // The control and real robots share a single copy of the module, the output robots share a copy of the canonical
+  // module
+  auto shareModule = [](const mc_rbdyn::RobotModule & module) -> mc_rbdyn::ConstRobotModulePtr {
+    return std::allocate_shared<const mc_rbdyn::RobotModule>(Eigen::aligned_allocator<mc_rbdyn::RobotModule>{}, module);
+  };
+  auto module = shareModule(*rm);
+  auto canonical = canonicalModule == rm ? module : shareModule(*canonicalModule);
   mc_rbdyn::LoadRobotParameters params{};
-  auto & robot = loadRobot(rm, name, robots(), params);
+  auto & robot = loadRobot(module, name, robots(), params);
   params.warn_on_missing_files(false).data(robot.data());
-  loadRobot(rm, name, realRobots(), params);
+  loadRobot(module, name, realRobots(), params);
   std::string urdf;
   auto loadUrdf = [&canonicalModule, &urdf]() -> const std::string & {
     if(urdf.size())
@@ -399,7 +406,7 @@ mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm, const std
                        canonicalModule->name);
     mc_rtc::log::error_and_throw("Failed to initialize grippers");
   };
-  auto & outputRobot = loadRobot(canonicalModule, name, *outputRobots_, params);
+  auto & outputRobot = loadRobot(canonical, name, *outputRobots_, params);
   for(const auto & gripper : canonicalModule->grippers())
   {
     auto mimics = gripper.mimics();
@@ -416,7 +423,7 @@ mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm, const std
     }
     robot.data()->grippersRef.push_back(std::ref(*robot.data()->grippers[gripper.name]));
   }
-  loadRobot(canonicalModule, name, *outputRealRobots_, params);
+  loadRobot(canonical, name, *outputRealRobots_, params);
   addRobotToLog(robot);
   addRobotToGUI(robot);
   if(solver().backend() == Backend::Tasks)
@@ -440,6 +447,19 @@ mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::RobotModulePtr rm,
   return r;
 }
 
+mc_rbdyn::Robot & MCController::loadRobot(mc_rbdyn::ConstRobotModulePtr rm,
+                                          const std::string & name,
+                                          mc_rbdyn::Robots & robots,
+                                          const mc_rbdyn::LoadRobotParameters & params)
+{
+  assert(rm);
+  auto & r = robots.load(name, std::move(rm), params);
+  r.mbc().gravity = mc_rtc::constants::gravity;
+  r.forwardKinematics();
+  r.forwardVelocity();
+  return r;
+}
+
 void MCController::addRobotToGUI(const mc_rbdyn::Robot & r)
 {
   if(!gui_)
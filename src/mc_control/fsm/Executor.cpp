@@ -6,10 +6,14 @@
 
 #include <mc_control/fsm/Controller.h>
 
+#include <mc_rtc/Tracing.h>
 #include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Form.h>
 #include <mc_rtc/gui/Label.h>
 
+#include <algorithm>
+#include <optional>
+
 namespace mc_control
 {
 
@@ -24,6 +28,19 @@ using clock = typename std::conditional<std::chrono::high_resolution_clock::is_s
                                         std::chrono::steady_clock>::type;
 } // namespace
 
+Executor::~Executor()
+{
+  if(prebuild_thread_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(prebuild_mutex_);
+      prebuild_stop_ = true;
+    }
+    prebuild_cv_.notify_one();
+    prebuild_thread_.join();
+  }
+}
+
 void Executor::init(Controller & ctl,
                     const mc_rtc::Configuration & config,
                     const std::string & name,
@@ -33,6 +50,7 @@ void Executor::init(Controller & ctl,
   name_ = name;
   config("Managed", managed_);
   config("StepByStep", step_by_step_);
+  config("Prebuild", prebuild_);
   if(!managed_)
   {
     transition_map_.init(ctl.factory(), config);
@@ -84,6 +102,7 @@ void Executor::init(Controller & ctl,
 
 bool Executor::run(Controller & ctl, bool keep_state)
 {
+  collectPrebuilt();
   if(interrupt_triggered_)
   {
     interrupt_triggered_ = false;
@@ -103,7 +122,12 @@ bool Executor::run(Controller & ctl, bool keep_state)
   if(state_)
   {
     auto start_run = clock::now();
-    if(!(state_->run(ctl) || ready_))
+    bool state_completed = false;
+    {
+      MC_RTC_TRACE_SPAN("State::run", curr_state_);
+      state_completed = state_->run(ctl);
+    }
+    if(!(state_completed || ready_))
     {
       state_run_dt_ = clock::now() - start_run;
       return false;
@@ -153,6 +177,21 @@ void Executor::stop(Controller & ctl)
 
 void Executor::teardown(Controller & ctl)
 {
+  if(prebuild_thread_.joinable())
+  {
+    // The background thread destroys the states and exits without blocking this thread, it is joined on destruction
+    {
+      std::lock_guard<std::mutex> lock(prebuild_mutex_);
+      for(auto & s : prebuilt_)
+      {
+        prebuild_discard_.push_back(std::move(s.second));
+      }
+      prebuild_states_.clear();
+      prebuild_stop_ = true;
+    }
+    prebuild_cv_.notify_one();
+  }
+  prebuilt_.clear();
   if(state_)
   {
     state_->teardown_(ctl);
@@ -170,6 +209,7 @@ bool Executor::complete(Controller & ctl, bool keep_state)
   if(!keep_state)
   {
     auto start_teardown = clock::now();
+    MC_RTC_TRACE_SPAN("State::teardown", curr_state_);
     state_->teardown_(ctl);
     state_ = nullptr;
     state_teardown_dt_ = clock::now() - start_teardown;
@@ -199,23 +239,33 @@ void Executor::next(Controller & ctl)
   if(state_)
   {
     auto state_teardown_start = clock::now();
+    MC_RTC_TRACE_SPAN("State::teardown", curr_state_);
     state_->teardown_(ctl);
     ctl.resetPostures();
     state_teardown_dt_ = clock::now() - state_teardown_start;
   }
   mc_rtc::log::success("Starting state {}", next_state_);
-  if(config_.has("configs") && config_("configs").has(next_state_))
-  {
-    auto state_create_start = clock::now();
-    state_ = ctl.factory().create(next_state_, ctl, config_("configs")(next_state_));
-    state_create_dt_ = clock::now() - state_create_start;
-  }
-  else
+  auto state_create_start = clock::now();
   {
-    auto state_create_start = clock::now();
-    state_ = ctl.factory().create(next_state_, ctl);
-    state_create_dt_ = clock::now() - state_create_start;
+    MC_RTC_TRACE_SPAN("State::create", next_state_);
+    collectPrebuilt();
+    auto prebuilt = prebuilt_.find(next_state_);
+    if(prebuilt != prebuilt_.end())
+    {
+      state_ = std::move(prebuilt->second);
+      prebuilt_.erase(prebuilt);
+      state_->start_(ctl);
+    }
+    else if(config_.has("configs") && config_("configs").has(next_state_))
+    {
+      state_ = ctl.factory().create(next_state_, ctl, config_("configs")(next_state_));
+    }
+    else
+    {
+      state_ = ctl.factory().create(next_state_, ctl);
+    }
   }
+  state_create_dt_ = clock::now() - state_create_start;
   auto gui = ctl.gui();
   if(gui)
   {
@@ -230,6 +280,164 @@ void Executor::next(Controller & ctl)
   }
   curr_state_ = next_state_;
   next_state_ = "";
+  prebuild(ctl);
+}
+
+void Executor::prebuild(Controller & ctl)
+{
+  if(!prebuild_ || managed_)
+  {
+    return;
+  }
+  if(prebuild_thread_.joinable() && prebuild_stop_)
+  {
+    // The executor was torn down and initialized again
+    prebuild_thread_.join();
+    prebuild_stop_ = false;
+  }
+  auto next_states = transition_map_.transitions(curr_state_);
+  {
+    std::lock_guard<std::mutex> lock(prebuild_mutex_);
+    // Collect the states created for the previous state, they might also follow this one
+    storePrebuilt();
+    for(auto it = prebuilt_.begin(); it != prebuilt_.end();)
+    {
+      if(next_states.erase(it->first))
+      {
+        ++it;
+      }
+      else
+      {
+        prebuild_discard_.push_back(std::move(it->second));
+        it = prebuilt_.erase(it);
+      }
+    }
+    // The states being created are collected once they are ready
+    for(const auto & s : prebuild_building_)
+    {
+      next_states.erase(s);
+    }
+    // Replace the work that was scheduled for the previous state but not started yet
+    prebuild_states_.clear();
+    // Configurations are retrieved here as config_ is only accessed from this thread
+    for(const auto & s : next_states)
+    {
+      if(config_.has("configs") && config_("configs").has(s))
+      {
+        prebuild_states_.emplace_back(s, config_("configs")(s));
+      }
+      else
+      {
+        prebuild_states_.emplace_back(s, std::nullopt);
+      }
+    }
+    if(prebuild_states_.empty() && prebuild_discard_.empty())
+    {
+      return;
+    }
+  }
+  if(!prebuild_thread_.joinable())
+  {
+    prebuild_thread_ = std::thread([this, &factory = ctl.factory()]() { prebuildLoop(factory); });
+  }
+  prebuild_cv_.notify_one();
+}
+
+void Executor::prebuildLoop(StateFactory & factory)
+{
+  std::unique_lock<std::mutex> lock(prebuild_mutex_);
+  while(true)
+  {
+    prebuild_cv_.wait(lock,
+                      [this]() { return prebuild_stop_ || prebuild_states_.size() || prebuild_discard_.size(); });
+    auto discard = std::move(prebuild_discard_);
+    prebuild_discard_.clear();
+    if(prebuild_stop_)
+    {
+      for(auto & s : prebuild_done_)
+      {
+        discard.push_back(std::move(s.second));
+      }
+      prebuild_done_.clear();
+      lock.unlock();
+      discard.clear();
+      return;
+    }
+    auto states = std::move(prebuild_states_);
+    prebuild_states_.clear();
+    for(const auto & s : states)
+    {
+      prebuild_building_.push_back(s.first);
+    }
+    lock.unlock();
+    discard.clear();
+    for(const auto & s : states)
+    {
+      StatePtr state = nullptr;
+      if(factory.hasState(s.first))
+      {
+        try
+        {
+          state = s.second ? factory.create(s.first, *s.second) : factory.create(s.first);
+        }
+        catch(const std::exception & exc)
+        {
+          // The state is created again on transition, which reports the error
+          mc_rtc::log::warning("[FSM] Failed to prebuild {}: {}", s.first, exc.what());
+        }
+      }
+      lock.lock();
+      prebuild_building_.erase(std::find(prebuild_building_.begin(), prebuild_building_.end(), s.first));
+      if(state)
+      {
+        prebuild_done_.emplace_back(s.first, std::move(state));
+      }
+      bool stop = prebuild_stop_;
+      lock.unlock();
+      if(stop)
+      {
+        break;
+      }
+    }
+    lock.lock();
+    prebuild_building_.clear();
+  }
+}
+
+void Executor::storePrebuilt()
+{
+  for(auto & s : prebuild_done_)
+  {
+    auto it = prebuilt_.find(s.first);
+    if(it == prebuilt_.end())
+    {
+      prebuilt_.emplace(std::move(s.first), std::move(s.second));
+    }
+    else
+    {
+      prebuild_discard_.push_back(std::move(s.second));
+    }
+  }
+  prebuild_done_.clear();
+}
+
+void Executor::collectPrebuilt()
+{
+  if(!prebuild_thread_.joinable())
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(prebuild_mutex_, std::try_to_lock);
+  if(!lock.owns_lock() || prebuild_done_.empty())
+  {
+    return;
+  }
+  storePrebuilt();
+  if(prebuild_discard_.size())
+  {
+    lock.unlock();
+    prebuild_cv_.notify_one();
+  }
 }
 
 bool Executor::resume(const std::string & state)
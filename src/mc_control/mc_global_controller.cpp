@@ -13,7 +13,11 @@
 
 #include <mc_rbdyn/RobotLoader.h>
 
+#include <mc_rtc/AllocationTracker.h>
 #include <mc_rtc/ConfigurationHelpers.h>
+#include <mc_rtc/Tracing.h>
+#include <mc_rtc/WorkerPool.h>
+#include <mc_rtc/clock.h>
 #include <mc_rtc/config.h>
 #include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Form.h>
@@ -25,6 +29,7 @@
 #include <boost/chrono.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iomanip>
@@ -34,14 +39,110 @@ namespace mc_control
 
 MCGlobalController::PluginHandle::~PluginHandle() {}
 
+MCGlobalController::AsyncPlugin::AsyncPlugin(const std::string & name,
+                                             GlobalPlugin * plugin,
+                                             bool always,
+                                             duration_ms deadline)
+: name(name), plugin(plugin), always(always), deadline(deadline), thread_([this]() { run(); })
+{
+}
+
+MCGlobalController::AsyncPlugin::~AsyncPlugin()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void MCGlobalController::AsyncPlugin::trigger(MCGlobalController & gc)
+{
+  {
+    // The worker only holds the lock briefly when it starts or finishes a processing
+    std::unique_lock<std::mutex> lock(mutex_);
+    if(busy_)
+    {
+      skipped++;
+      return;
+    }
+  }
+  // The worker does not touch the plugin while it is not busy
+  auto start_t = mc_rtc::clock::now();
+  MC_RTC_TRACE_SPAN("Plugin::capture", name);
+  mc_rtc::alloc::Scope alloc_scope("Plugin::capture");
+  plugin->capture(gc);
+  capture_dt = mc_rtc::clock::now() - start_t;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    busy_ = true;
+  }
+  cv_.notify_all();
+}
+
+void MCGlobalController::AsyncPlugin::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return !busy_; });
+}
+
+void MCGlobalController::AsyncPlugin::run()
+{
+#ifdef MC_RTC_ENABLE_TRACING
+  mc_rtc::trace::threadName("Plugin " + name);
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  while(true)
+  {
+    cv_.wait(lock, [this]() { return busy_ || !running_; });
+    if(!running_)
+    {
+      return;
+    }
+    lock.unlock();
+    auto start_t = mc_rtc::clock::now();
+    {
+      MC_RTC_TRACE_SPAN("Plugin::process", name);
+      plugin->process();
+    }
+    duration_ms dt = mc_rtc::clock::now() - start_t;
+    process_dt = dt.count();
+    if(dt > deadline)
+    {
+      // Report the first overrun and then every 1000 overruns
+      if(overruns.fetch_add(1) % 1000 == 0)
+      {
+        mc_rtc::log::warning("[MCGlobalController] Asynchronous plugin processing took {:.3f}ms (deadline: {:.3f}ms, "
+                             "overruns: {})",
+                             dt.count(), deadline.count(), overruns.load());
+      }
+    }
+    lock.lock();
+    busy_ = false;
+    cv_.notify_all();
+  }
+}
+
 MCGlobalController::MCGlobalController(const std::string & conf, std::shared_ptr<mc_rbdyn::RobotModule> rm)
 : MCGlobalController(GlobalConfiguration(conf, rm))
 {
 }
 
+const std::array<const char *, static_cast<size_t>(MCGlobalController::LatencyStage::Count)>
+    MCGlobalController::latency_stages_ = {
+        "Period", "GlobalRun", "ObserversRun", "ControllerRun", "SolverBuildAndSolve", "SolverSolve", "Log", "Gui"};
+
 MCGlobalController::MCGlobalController(const GlobalConfiguration & conf)
 : config(conf), current_ctrl(""), next_ctrl(""), controller_(nullptr), next_controller_(nullptr)
 {
+  // Statistics over the last second, the deadline of the compute stages is the controller timestep
+  size_t latency_window = std::max<size_t>(static_cast<size_t>(std::ceil(1.0 / config.timestep)), 1);
+  for(size_t i = 0; i < latency_.size(); ++i)
+  {
+    double deadline = i == static_cast<size_t>(LatencyStage::Period) ? 0.0 : 1000 * config.timestep;
+    latency_[i] = std::make_unique<mc_rtc::LatencyHistogram>(deadline, latency_window);
+  }
   // Loading plugins
   config.load_plugin_configs();
   try
@@ -81,9 +182,53 @@ MCGlobalController::MCGlobalController(const GlobalConfiguration & conf)
   {
     config.enabled_controllers.push_back("HalfSitPose");
   }
-  for(const auto & c : config.enabled_controllers)
+  // Controllers are created concurrently if requested then added in the order they are enabled
+  std::vector<std::shared_ptr<MCController>> created(config.enabled_controllers.size());
+  bool parallel_init = config.init_threads > 1 && created.size() > 1;
+  if(parallel_init)
   {
-    AddController(c);
+    // Configurations are fetched beforehand, nullptr marks a controller enabled twice
+    std::vector<const mc_rtc::Configuration *> configs;
+    for(auto it = config.enabled_controllers.begin(); it != config.enabled_controllers.end(); ++it)
+    {
+      bool duplicate = std::find(config.enabled_controllers.begin(), it, *it) != it;
+      configs.push_back(duplicate ? nullptr : &config.controllers_configs[*it]);
+    }
+    std::vector<std::exception_ptr> errors(created.size());
+    mc_rtc::WorkerPool pool(std::min(config.init_threads, created.size()) - 1);
+    pool.run(created.size(), [&](size_t i) {
+      if(!configs[i])
+      {
+        return;
+      }
+      try
+      {
+        created[i] = createController(config.enabled_controllers[i], *configs[i]);
+      }
+      catch(...)
+      {
+        errors[i] = std::current_exception();
+      }
+    });
+    for(const auto & e : errors)
+    {
+      if(e)
+      {
+        std::rethrow_exception(e);
+      }
+    }
+  }
+  for(size_t i = 0; i < config.enabled_controllers.size(); ++i)
+  {
+    const auto & c = config.enabled_controllers[i];
+    if(created[i])
+    {
+      addCreatedController(c, created[i]);
+    }
+    else if(!parallel_init || controllers.count(c))
+    {
+      AddController(c);
+    }
     if(c == config.initial_controller && controllers.count(c))
     {
       current_ctrl = c;
@@ -111,11 +256,15 @@ MCGlobalController::MCGlobalController(const GlobalConfiguration & conf)
   {
     server_.reset(new mc_control::ControllerServer(config.timestep, config.gui_timestep, config.gui_server_pub_uris,
                                                    config.gui_server_rep_uris));
+    server_->delta(config.gui_delta, config.gui_full_state_period);
+    server_->async(config.gui_async);
   }
 }
 
 MCGlobalController::~MCGlobalController()
 {
+  // Stop the processing of asynchronous plugins first
+  plugins_async_.clear();
   // We clear all datastore and gui before (potentially) unloading any libraries
   for(auto & ctl : controllers)
   {
@@ -294,6 +443,7 @@ void MCGlobalController::reset(const std::map<std::string, std::vector<double>>
   config.load_controllers_configs();
   AddController(current_ctrl);
   controller_ = controllers[current_ctrl].get();
+  controller_generation_++;
   init(initqs, initAttitudes, true);
 }
 
@@ -393,6 +543,10 @@ void MCGlobalController::initController(bool reset)
   controller_->reset({q});
   controller_->resetObserverPipelines();
   initGUI();
+  for(auto & plugin : plugins_async_)
+  {
+    plugin->wait();
+  }
   if(reset)
   {
     for(auto & plugin : plugins_)
@@ -733,13 +887,59 @@ void MCGlobalController::setJointMotorCurrents(const std::string & robotName,
   }
 }
 
+MCGlobalController::SensorHandles MCGlobalController::sensorHandles(const std::string & robot,
+                                                                  const std::vector<std::string> & bodySensors,
+                                                                  const std::vector<std::string> & forceSensors,
+                                                                  const std::vector<std::string> & joints)
+{
+  SensorHandles handles;
+  handles.robot = robot;
+  handles.bodySensors = bodySensors;
+  handles.forceSensors = forceSensors;
+  handles.joints = joints;
+  resolveSensors(handles);
+  return handles;
+}
+
+void MCGlobalController::resolveSensors(SensorHandles & handles)
+{
+  auto & data = *controller().robot(handles.robot).data();
+  auto resolve = [&](const std::vector<std::string> & names, const std::unordered_map<std::string, size_t> & index,
+                     std::vector<size_t> & out, const char * type) {
+    out.resize(names.size());
+    for(size_t i = 0; i < names.size(); ++i)
+    {
+      auto it = index.find(names[i]);
+      if(it == index.end())
+      {
+        mc_rtc::log::error_and_throw("No {} named {} in robot {}", type, names[i], handles.robot);
+      }
+      out[i] = it->second;
+    }
+  };
+  resolve(handles.bodySensors, data.bodySensorsIndex, handles.bodySensorsIndex_, "body sensor");
+  resolve(handles.forceSensors, data.forceSensorsIndex, handles.forceSensorsIndex_, "force sensor");
+  resolve(handles.joints, data.jointJointSensors, handles.jointSensorsIndex_, "joint sensor for joint");
+  handles.data_ = &data;
+  handles.generation_ = controller_generation_;
+  handles.robots_generation_ = controller().robots().generation();
+}
+
 bool MCGlobalController::run()
 {
-  /** Always pick a steady clock */
-  using clock = typename std::conditional<std::chrono::high_resolution_clock::is_steady,
-                                          std::chrono::high_resolution_clock, std::chrono::steady_clock>::type;
+  MC_RTC_TRACE_TICK();
+  MC_RTC_TRACE_SPAN("MCGlobalController::run");
+  mc_rtc::alloc::Scope alloc_scope("MCGlobalController::run");
   /** Helper to converst Tasks' timer */
-  auto start_run_t = clock::now();
+  auto start_run_t = mc_rtc::clock::now();
+  {
+    auto run_t = std::chrono::duration_cast<std::chrono::nanoseconds>(start_run_t.time_since_epoch());
+    if(last_run_t_.count() != 0)
+    {
+      recordLatency(LatencyStage::Period, duration_ms(run_t - last_run_t_).count());
+    }
+    last_run_t_ = run_t;
+  }
   /* Check if we need to change the controller this time */
   if(next_controller_)
   {
@@ -770,6 +970,7 @@ bool MCGlobalController::run()
         js.motorCurrent(controller_->robot().jointJointSensor(js.joint()).motorCurrent());
       }
       next_controller_->realRobot().mbc() = controller_->realRobot().mbc();
+      next_controller_->realRobot().invalidateKinematicsCache();
     }
     if(!running)
     {
@@ -797,6 +998,10 @@ bool MCGlobalController::run()
       next_controller_->resetObserverPipelines();
       controller_ = next_controller_;
       /** Reset plugins */
+      for(auto & plugin : plugins_async_)
+      {
+        plugin->wait();
+      }
       for(auto & plugin : plugins_)
       {
         plugin.plugin->reset(*this);
@@ -804,6 +1009,7 @@ bool MCGlobalController::run()
       resetControllerPlugins();
     }
     next_controller_ = nullptr;
+    controller_generation_++;
     current_ctrl = next_ctrl;
     if(config.enable_log)
     {
@@ -817,17 +1023,28 @@ bool MCGlobalController::run()
     mc_solver::QPSolver::context_backend(controller_->solver().backend());
     for(auto & plugin : plugins_before_)
     {
-      auto start_t = clock::now();
+      auto start_t = mc_rtc::clock::now();
+      MC_RTC_TRACE_SPAN("Plugin::before", plugin.name);
+      mc_rtc::alloc::Scope plugin_scope("Plugin::before");
       plugin.plugin->before(*this);
-      plugin.plugin_before_dt = clock::now() - start_t;
+      plugin.plugin_before_dt = mc_rtc::clock::now() - start_t;
     }
-    auto start_observers_run_t = clock::now();
-    controller_->runObserverPipelines();
-    observers_run_dt = clock::now() - start_observers_run_t;
+    auto start_observers_run_t = mc_rtc::clock::now();
+    {
+      MC_RTC_TRACE_SPAN("MCController::runObserverPipelines");
+      mc_rtc::alloc::Scope observers_scope("MCController::runObserverPipelines");
+      controller_->runObserverPipelines();
+    }
+    observers_run_dt = mc_rtc::clock::now() - start_observers_run_t;
 
-    auto start_controller_run_t = clock::now();
-    bool r = controller_->run();
-    auto end_controller_run_t = clock::now();
+    auto start_controller_run_t = mc_rtc::clock::now();
+    bool r = false;
+    {
+      MC_RTC_TRACE_SPAN("MCController::run");
+      mc_rtc::alloc::Scope controller_scope("MCController::run");
+      r = controller_->run();
+    }
+    auto end_controller_run_t = mc_rtc::clock::now();
 
     for(size_t i = 0; i < controller_->robots().size(); ++i)
     {
@@ -851,29 +1068,49 @@ bool MCGlobalController::run()
     }
     if(config.enable_log)
     {
-      auto start_log_t = clock::now();
+      auto start_log_t = mc_rtc::clock::now();
       controller_->logger().log();
-      log_dt = clock::now() - start_log_t;
+      log_dt = mc_rtc::clock::now() - start_log_t;
     }
     if(server_)
     {
-      auto start_gui_t = clock::now();
+      auto start_gui_t = mc_rtc::clock::now();
+      MC_RTC_TRACE_SPAN("ControllerServer");
+      mc_rtc::alloc::Scope gui_scope("ControllerServer");
       server_->handle_requests(*controller_->gui_);
       server_->publish(*controller_->gui_);
-      gui_dt = clock::now() - start_gui_t;
+      gui_dt = mc_rtc::clock::now() - start_gui_t;
     }
     controller_run_dt = end_controller_run_t - start_controller_run_t;
     solver_build_and_solve_t = controller_->solver().solveAndBuildTime();
     solver_solve_t = controller_->solver().solveTime();
+    recordLatency(LatencyStage::ObserversRun, observers_run_dt.count());
+    recordLatency(LatencyStage::ControllerRun, controller_run_dt.count());
+    recordLatency(LatencyStage::SolverBuildAndSolve, solver_build_and_solve_t);
+    recordLatency(LatencyStage::SolverSolve, solver_solve_t);
+    if(config.enable_log)
+    {
+      recordLatency(LatencyStage::Log, log_dt.count());
+    }
+    if(server_)
+    {
+      recordLatency(LatencyStage::Gui, gui_dt.count());
+    }
     if(!r)
     {
       running = false;
     }
     for(auto & plugin : plugins_after_)
     {
-      auto start_t = clock::now();
+      auto start_t = mc_rtc::clock::now();
+      MC_RTC_TRACE_SPAN("Plugin::after", plugin.name);
+      mc_rtc::alloc::Scope plugin_scope("Plugin::after");
       plugin.plugin->after(*this);
-      plugin.plugin_after_dt = clock::now() - start_t;
+      plugin.plugin_after_dt = mc_rtc::clock::now() - start_t;
+    }
+    for(auto & plugin : plugins_async_)
+    {
+      plugin->trigger(*this);
     }
   }
   else
@@ -887,17 +1124,28 @@ bool MCGlobalController::run()
     solver_solve_t = 0;
     if(server_)
     {
-      auto start_gui_t = clock::now();
+      auto start_gui_t = mc_rtc::clock::now();
+      MC_RTC_TRACE_SPAN("ControllerServer");
+      mc_rtc::alloc::Scope gui_scope("ControllerServer");
       server_->handle_requests(*controller_->gui_);
       server_->publish(*controller_->gui_);
-      gui_dt = clock::now() - start_gui_t;
+      gui_dt = mc_rtc::clock::now() - start_gui_t;
+      recordLatency(LatencyStage::Gui, gui_dt.count());
     }
     for(auto & plugin : plugins_after_always_)
     {
       plugin->after(*this);
     }
+    for(auto & plugin : plugins_async_)
+    {
+      if(plugin->always)
+      {
+        plugin->trigger(*this);
+      }
+    }
   }
-  global_run_dt = clock::now() - start_run_t;
+  global_run_dt = mc_rtc::clock::now() - start_run_t;
+  recordLatency(LatencyStage::GlobalRun, global_run_dt.count());
   // Percentage of time not spent inside the user code
   framework_cost = 100 * (1 - controller_run_dt.count() / global_run_dt.count());
   return running;
@@ -951,6 +1199,45 @@ double MCGlobalController::timestep() const
   return config.timestep;
 }
 
+const mc_rtc::LatencyHistogram & MCGlobalController::latencyStatistics(const std::string & stage) const
+{
+  auto it = std::find(latency_stages_.begin(), latency_stages_.end(), stage);
+  if(it == latency_stages_.end())
+  {
+    mc_rtc::log::error_and_throw("No latency statistics for stage {}", stage);
+  }
+  return *latency_[static_cast<size_t>(std::distance(latency_stages_.begin(), it))];
+}
+
+mc_rtc::Configuration MCGlobalController::latencyStatistics() const
+{
+  mc_rtc::Configuration out;
+  for(size_t i = 0; i < latency_.size(); ++i)
+  {
+    auto summary = latency_[i]->summary();
+    auto stage = out.add(latency_stages_[i]);
+    stage.add("count", summary.count);
+    stage.add("mean", summary.mean);
+    stage.add("p50", summary.p50);
+    stage.add("p99", summary.p99);
+    stage.add("p99.9", summary.p999);
+    stage.add("max", summary.max);
+    stage.add("jitter", summary.jitter);
+    stage.add("deadline", latency_[i]->deadline());
+    stage.add("deadline_misses", summary.deadline_misses);
+  }
+  return out;
+}
+
+void MCGlobalController::resetLatencyStatistics()
+{
+  for(auto & l : latency_)
+  {
+    l->reset();
+  }
+  last_run_t_ = std::chrono::nanoseconds{0};
+}
+
 const std::vector<std::string> & MCGlobalController::ref_joint_order()
 {
   return controller().robot().refJointOrder();
@@ -963,6 +1250,12 @@ bool MCGlobalController::AddController(const std::string & name)
     mc_rtc::log::warning("Controller {} already enabled", name);
     return false;
   }
+  return addCreatedController(name, createController(name, config.controllers_configs[name]));
+}
+
+std::shared_ptr<MCController> MCGlobalController::createController(const std::string & name,
+                                                                   const mc_rtc::Configuration & ctl_config)
+{
   std::string controller_name = name;
   std::string controller_subname = "";
   size_t sep_pos = name.find('#');
@@ -976,34 +1269,36 @@ bool MCGlobalController::AddController(const std::string & name)
 #else
   auto * controller_loader = &ControllerLoader::loader();
 #endif
-  if(controller_loader->has_object(controller_name))
+  if(!controller_loader->has_object(controller_name))
   {
-    mc_rtc::log::info("Create controller {}", controller_name);
-    if(controller_subname != "")
-    {
-      controllers[name] =
-          controller_loader->create_object(controller_name, controller_subname, config.main_robot_module,
-                                           config.timestep, config.controllers_configs[name]);
-    }
-    else
-    {
-      controllers[name] = controller_loader->create_object(name, config.main_robot_module, config.timestep,
-                                                           config.controllers_configs[name]);
-    }
-    controllers[name]->datastore().make_call("Global::EnableController",
-                                             [this](const std::string & name) { return EnableController(name); });
-    if(config.enable_log)
-    {
-      controllers[name]->logger().setup(config.log_policy, config.log_directory, config.log_template);
-    }
-    controllers[name]->createObserverPipelines(config.controllers_configs[name]);
-    return true;
+    mc_rtc::log::warning("Controller {} enabled in configuration but not available", name);
+    return nullptr;
   }
-  else
+  mc_rtc::log::info("Create controller {}", controller_name);
+  if(controller_subname != "")
+  {
+    return controller_loader->create_object(controller_name, controller_subname, config.main_robot_module,
+                                            config.timestep, ctl_config);
+  }
+  return controller_loader->create_object(name, config.main_robot_module, config.timestep, ctl_config);
+}
+
+bool MCGlobalController::addCreatedController(const std::string & name, std::shared_ptr<MCController> controller)
+{
+  if(!controller)
   {
-    mc_rtc::log::warning("Controller {} enabled in configuration but not available", name);
     return false;
   }
+  controllers[name] = controller;
+  controller->datastore().make_call("Global::EnableController",
+                                    [this](const std::string & name) { return EnableController(name); });
+  controller->datastore().make_call("Global::LatencyStatistics", [this]() { return latencyStatistics(); });
+  if(config.enable_log)
+  {
+    controller->logger().setup(config.log_policy, config.log_directory, config.log_template);
+  }
+  controller->createObserverPipelines(config.controllers_configs[name]);
+  return true;
 }
 
 const MCGlobalController::GlobalConfiguration & MCGlobalController::configuration() const
@@ -1114,6 +1409,20 @@ void MCGlobalController::setup_log()
     controller->logger().addLogEntry(fmt::format("perf_Plugins_{}_after", name),
                                      [&plugin]() { return plugin.plugin_after_dt.count(); });
   }
+  for(const auto & p : plugins_async_)
+  {
+    // The entries are removed when the plugin is removed (see resetControllerPlugins)
+    AsyncPlugin * plugin = p.get();
+    const auto & name = getPluginName(plugin->plugin);
+    controller->logger().addLogEntry(fmt::format("perf_Plugins_{}_capture", name), plugin,
+                                     [plugin]() { return plugin->capture_dt.count(); });
+    controller->logger().addLogEntry(fmt::format("perf_Plugins_{}_process", name), plugin,
+                                     [plugin]() { return plugin->process_dt.load(); });
+    controller->logger().addLogEntry(fmt::format("perf_Plugins_{}_overruns", name), plugin,
+                                     [plugin]() { return plugin->overruns.load(); });
+    controller->logger().addLogEntry(fmt::format("perf_Plugins_{}_skipped", name), plugin,
+                                     [plugin]() { return plugin->skipped; });
+  }
   // Log system wall time as nanoseconds since epoch (can be used to manage synchronization with ros)
   controller->logger().addLogEntry("timeWall", []() -> int64_t {
     int64_t nanoseconds_since_epoch = std::chrono::system_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
@@ -1136,15 +1445,21 @@ GlobalPlugin * MCGlobalController::loadPlugin(const std::string & name, const ch
     const auto & plugin_config = plugins_.back().plugin->configuration();
     if(plugin_config.should_run_before)
     {
-      plugins_before_.push_back({plugin, duration_ms{0}});
+      plugins_before_.push_back({plugin, duration_ms{0}, name});
       if(plugin_config.should_always_run)
       {
         plugins_before_always_.push_back(plugin);
       }
     }
-    if(plugin_config.should_run_after)
+    if(plugin_config.async)
+    {
+      double deadline = plugin_config.async_deadline > 0 ? plugin_config.async_deadline : config.timestep;
+      plugins_async_.push_back(std::make_unique<AsyncPlugin>(name, plugin, plugin_config.should_always_run,
+                                                             duration_ms{1000 * deadline}));
+    }
+    else if(plugin_config.should_run_after)
     {
-      plugins_after_.push_back({plugin, duration_ms{0}});
+      plugins_after_.push_back({plugin, duration_ms{0}, name});
       if(plugin_config.should_always_run)
       {
         plugins_after_always_.push_back(plugin);
@@ -1205,6 +1520,17 @@ void MCGlobalController::resetControllerPlugins()
       {
         plugins_after_always_.erase(it_after_always);
       }
+      auto it_async =
+          std::find_if(plugins_async_.begin(), plugins_async_.end(),
+                       [&](const std::unique_ptr<AsyncPlugin> & p) { return p->plugin == it->plugin.get(); });
+      if(it_async != plugins_async_.end())
+      {
+        for(auto & ctl : controllers)
+        {
+          ctl.second->logger().removeLogEntries(it_async->get());
+        }
+        plugins_async_.erase(it_async);
+      }
       // Finally we can remove the handle
       it = controller_plugins_.erase(it);
     }
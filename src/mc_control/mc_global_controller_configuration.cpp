@@ -5,6 +5,7 @@
 #include <mc_control/mc_global_controller.h>
 #include <mc_observers/ObserverLoader.h>
 #include <mc_rbdyn/RobotLoader.h>
+#include <mc_rbdyn/SCHAddon.h>
 #include <mc_rtc/ConfigurationHelpers.h>
 
 #include <boost/filesystem.hpp>
@@ -52,6 +53,11 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
   ///////////////////////
   //  General options  //
   ///////////////////////
+  if(config.has("ConfigurationCache"))
+  {
+    std::string configuration_cache = config("ConfigurationCache");
+    mc_rtc::Configuration::cacheDirectory(configuration_cache);
+  }
   config("VerboseLoader", verbose_loader);
   config("Timestep", timestep);
 
@@ -75,6 +81,11 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
       mc_rtc::log::error_and_throw("Failed to update robot module path(s)");
     }
   }
+  if(config.has("PolyhedronCache"))
+  {
+    std::string polyhedron_cache = config("PolyhedronCache");
+    sch::mc_rbdyn::setPolyhedronCacheDirectory(polyhedron_cache);
+  }
   if(rm)
   {
     main_robot_module = rm;
@@ -234,6 +245,7 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
   }
   config("Default", initial_controller);
   config("IncludeHalfSitController", include_halfsit_controller);
+  config("InitThreads", init_threads);
 
   ////////////////////
   // Initialization //
@@ -256,6 +268,10 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
     {
       log_policy = mc_rtc::Logger::Policy::NON_THREADED;
     }
+    else if(log_policy_str == "snapshot")
+    {
+      log_policy = mc_rtc::Logger::Policy::SNAPSHOT;
+    }
     else
     {
       mc_rtc::log::warning("Unrecognized LogPolicy entry, will default to non-threaded");
@@ -285,6 +301,9 @@ MCGlobalController::GlobalConfiguration::GlobalConfiguration(const std::string &
     {
       gui_timestep = timestep;
     }
+    gui_config("Delta", gui_delta);
+    gui_config("FullStatePeriod", gui_full_state_period);
+    gui_config("Async", gui_async);
     if(gui_config.has("IPC"))
     {
       auto ipc_config = gui_config("IPC");
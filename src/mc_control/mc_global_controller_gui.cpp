@@ -4,11 +4,19 @@
 
 #include <mc_control/mc_global_controller.h>
 
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/Tracing.h>
 #include <mc_rtc/gui/Button.h>
+#include <mc_rtc/gui/Checkbox.h>
 #include <mc_rtc/gui/Form.h>
 #include <mc_rtc/gui/Label.h>
 #include <mc_rtc/gui/NumberInput.h>
 
+#include <boost/filesystem.hpp>
+namespace bfs = boost::filesystem;
+
+#include <ctime>
+
 /** This file implements GUI elements related to the global controller instance
  *  and available for each controller */
 
@@ -82,6 +90,47 @@ void MCGlobalController::initGUI()
         }
       }
     }
+    gui->removeCategory({"Global", "Performance"});
+    gui->addElement({"Global", "Performance"},
+                    mc_rtc::gui::Button("Reset statistics", [this]() { resetLatencyStatistics(); }),
+                    mc_rtc::gui::Button("Dump statistics", [this]() {
+                      auto path = (bfs::path(config.log_directory)
+                                   / fmt::format("mc-control-{}-latency-{}.yaml", current_ctrl, std::time(nullptr)))
+                                      .string();
+                      latencyStatistics().save(path);
+                      mc_rtc::log::info("Latency statistics saved to {}", path);
+                    }));
+    for(size_t i = 0; i < latency_.size(); ++i)
+    {
+      const auto & l = *latency_[i];
+      gui->addElement({"Global", "Performance"}, mc_rtc::gui::Label(latency_stages_[i], [&l]() {
+                        auto s = l.summary();
+                        return fmt::format("p50 {:.3f} | p99 {:.3f} | p99.9 {:.3f} | max {:.3f} | jitter {:.3f} ms | "
+                                           "misses {}",
+                                           s.p50, s.p99, s.p999, s.max, s.jitter, s.deadline_misses);
+                      }));
+    }
+    if(mc_rtc::alloc::available())
+    {
+      gui->addElement({"Global", "Performance"},
+                      mc_rtc::gui::Checkbox(
+                          "Track allocations", []() { return mc_rtc::alloc::enabled(); },
+                          []() { mc_rtc::alloc::enable(!mc_rtc::alloc::enabled()); }),
+                      mc_rtc::gui::Label("Allocations", []() { return mc_rtc::alloc::allocations(); }),
+                      mc_rtc::gui::Button("Reset allocations", []() { mc_rtc::alloc::reset(); }),
+                      mc_rtc::gui::Button("Report allocations", []() { mc_rtc::alloc::report(); }));
+    }
+#ifdef MC_RTC_ENABLE_TRACING
+    gui->addElement({"Global", "Performance"}, mc_rtc::gui::Button("Dump trace (last 100 ticks)", [this]() {
+                      auto path = (bfs::path(config.log_directory)
+                                   / fmt::format("mc-control-{}-trace-{}.json", current_ctrl, std::time(nullptr)))
+                                      .string();
+                      if(mc_rtc::trace::dump(path, 100))
+                      {
+                        mc_rtc::log::info("Trace saved to {}", path);
+                      }
+                    }));
+#endif
     gui->removeCategory({"Global", "Change controller"});
     gui->addElement({"Global", "Change controller"},
                     mc_rtc::gui::Label("Current controller", [this]() { return current_ctrl; }),
@@ -1,6 +1,7 @@
 #include <mc_observers/ObserverLoader.h>
 #include <mc_observers/ObserverPipeline.h>
 #include <mc_rtc/ConfigurationHelpers.h>
+#include <mc_rtc/Tracing.h>
 #include <mc_rtc/io_utils.h>
 
 namespace mc_observers
@@ -100,7 +101,11 @@ bool ObserverPipeline::run()
   for(auto & pipelineObserver : pipelineObservers_)
   {
     auto & observer = pipelineObserver.observer();
-    bool res = observer.run(ctl_);
+    bool res = false;
+    {
+      MC_RTC_TRACE_SPAN("Observer::run", observer.name());
+      res = observer.run(ctl_);
+    }
     if(!res)
     {
       if(pipelineObserver.successRequired())
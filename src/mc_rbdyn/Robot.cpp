@@ -748,15 +748,33 @@ const sva::MotionVecd & Robot::bodyAccB(const std::string & name) const
 
 Eigen::Vector3d Robot::com() const
 {
-  return rbd::computeCoM(mb(), mbc());
+  auto & cache = kinematics_cache_;
+  if(cache.com_generation != mbc_generation_)
+  {
+    cache.com = rbd::computeCoM(mb(), mbc());
+    cache.com_generation = mbc_generation_;
+  }
+  return cache.com;
 }
 Eigen::Vector3d Robot::comVelocity() const
 {
-  return rbd::computeCoMVelocity(mb(), mbc());
+  auto & cache = kinematics_cache_;
+  if(cache.comVelocity_generation != mbc_generation_)
+  {
+    cache.comVelocity = rbd::computeCoMVelocity(mb(), mbc());
+    cache.comVelocity_generation = mbc_generation_;
+  }
+  return cache.comVelocity;
 }
 Eigen::Vector3d Robot::comAcceleration() const
 {
-  return rbd::computeCoMAcceleration(mb(), mbc());
+  auto & cache = kinematics_cache_;
+  if(cache.comAcceleration_generation != mbc_generation_)
+  {
+    cache.comAcceleration = rbd::computeCoMAcceleration(mb(), mbc());
+    cache.comAcceleration_generation = mbc_generation_;
+  }
+  return cache.comAcceleration;
 }
 
 sva::ForceVecd Robot::bodyWrench(const std::string & bodyName) const
@@ -1242,6 +1260,7 @@ unsigned int mc_rbdyn::Robot::robotIndex() const
 void Robot::forwardKinematics()
 {
   rbd::forwardKinematics(mb(), mbc());
+  invalidateKinematicsCache();
 }
 void Robot::forwardKinematics(rbd::MultiBodyConfig & mbc) const
 {
@@ -1251,6 +1270,7 @@ void Robot::forwardKinematics(rbd::MultiBodyConfig & mbc) const
 void Robot::forwardVelocity()
 {
   rbd::forwardVelocity(mb(), mbc());
+  invalidateKinematicsCache();
 }
 void Robot::forwardVelocity(rbd::MultiBodyConfig & mbc) const
 {
@@ -1260,6 +1280,7 @@ void Robot::forwardVelocity(rbd::MultiBodyConfig & mbc) const
 void Robot::forwardAcceleration(const sva::MotionVecd & A_0)
 {
   rbd::forwardAcceleration(mb(), mbc(), A_0);
+  invalidateKinematicsCache();
 }
 void Robot::forwardAcceleration(rbd::MultiBodyConfig & mbc, const sva::MotionVecd & A_0) const
 {
@@ -1269,6 +1290,7 @@ void Robot::forwardAcceleration(rbd::MultiBodyConfig & mbc, const sva::MotionVec
 void mc_rbdyn::Robot::eulerIntegration(double step)
 {
   rbd::integration(mb(), mbc(), step);
+  invalidateKinematicsCache();
 }
 
 void mc_rbdyn::Robot::eulerIntegration(rbd::MultiBodyConfig & mbc, double step) const
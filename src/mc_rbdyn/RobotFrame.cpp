@@ -36,19 +36,40 @@ const std::string & RobotFrame::body() const noexcept
 
 sva::PTransformd RobotFrame::position() const noexcept
 {
-  if(!parent_)
+  const Robot & robot = robot_;
+  if(position_generation_ != robot.mbc_generation_)
   {
-    return position_ * robot_.mbc().bodyPosW[bodyMbcIdx_];
+    if(!parent_)
+    {
+      position_cache_ = position_ * robot.mbc().bodyPosW[bodyMbcIdx_];
+    }
+    else
+    {
+      position_cache_ = position_ * static_cast<RobotFrame *>(parent_.get())->position();
+    }
+    position_generation_ = robot.mbc_generation_;
   }
-  return position_ * static_cast<RobotFrame *>(parent_.get())->position();
+  return position_cache_;
 }
 
 sva::MotionVecd RobotFrame::velocity() const noexcept
 {
-  auto X_0_parent = parent_ ? parent_->position() : robot_.mbc().bodyPosW[bodyMbcIdx_];
-  auto vel = parent_ ? static_cast<RobotFrame *>(parent_.get())->velocity() : robot_.mbc().bodyVelW[bodyMbcIdx_];
-  vel.linear() += -hat(X_0_parent.rotation().transpose() * position_.translation()) * vel.angular();
-  return vel;
+  const Robot & robot = robot_;
+  if(velocity_generation_ != robot.mbc_generation_)
+  {
+    auto X_0_parent = parent_ ? parent_->position() : robot.mbc().bodyPosW[bodyMbcIdx_];
+    velocity_cache_ =
+        parent_ ? static_cast<RobotFrame *>(parent_.get())->velocity() : robot.mbc().bodyVelW[bodyMbcIdx_];
+    velocity_cache_.linear() +=
+        -hat(X_0_parent.rotation().transpose() * position_.translation()) * velocity_cache_.angular();
+    velocity_generation_ = robot.mbc_generation_;
+  }
+  return velocity_cache_;
+}
+
+void RobotFrame::changed() noexcept
+{
+  robot_.mbc_generation_++;
 }
 
 const ForceSensor & RobotFrame::forceSensor() const
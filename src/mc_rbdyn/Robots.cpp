@@ -52,6 +52,7 @@ void Robots::copy(Robots & out) const
   {
     return;
   }
+  out.generation_++;
   out.robots_.clear();
   out.robot_modules_ = robot_modules_;
   out.mbs_ = mbs_;
@@ -172,6 +173,7 @@ void Robots::removeRobot(unsigned int idx)
     mc_rtc::log::error("Cannot remove a robot at index {} because there is {} robots loaded", idx, robots_.size());
     return;
   }
+  generation_++;
   const auto & robotName = robots_[idx]->name();
   robotNameToIndex_.erase(robotName);
   robot_modules_.erase(robot_modules_.begin() + idx);
@@ -194,7 +196,8 @@ void Robots::robotCopy(const Robot & robot, const std::string & copyName)
     mc_rtc::log::error_and_throw("Cannot copy robot {} to {}: a robot named {} already exists", robot.name(), copyName,
                                  copyName);
   }
-  this->robot_modules_.push_back(robot.module());
+  generation_++;
+  this->robot_modules_.push_back(robot.robots_->robot_modules_[robot.robots_idx_]);
   this->mbs_.push_back(robot.mb());
   this->mbcs_.push_back(robot.mbc());
   this->mbgs_.push_back(robot.mbg());
@@ -214,10 +217,20 @@ Robot & Robots::load(const std::string & name, const RobotModule & module, const
   {
     mc_rtc::log::error_and_throw("Robot names are required to be unique but a robot named {} already exists.", name);
   }
-  robot_modules_.emplace_back(module);
-  mbs_.emplace_back(module.mb);
-  mbcs_.emplace_back(module.mbc);
-  mbgs_.emplace_back(module.mbg);
+  return load(name, std::allocate_shared<const RobotModule>(Eigen::aligned_allocator<RobotModule>{}, module), params);
+}
+
+Robot & Robots::load(const std::string & name, ConstRobotModulePtr module, const LoadRobotParameters & params)
+{
+  if(hasRobot(name))
+  {
+    mc_rtc::log::error_and_throw("Robot names are required to be unique but a robot named {} already exists.", name);
+  }
+  generation_++;
+  mbs_.emplace_back(module->mb);
+  mbcs_.emplace_back(module->mbc);
+  mbgs_.emplace_back(module->mbg);
+  robot_modules_.push_back(std::move(module));
   robots_.push_back(std::make_shared<Robot>(Robot::NewRobotToken{}, name, *this,
                                             static_cast<unsigned int>(mbs_.size() - 1), true, params));
   robotNameToIndex_[name] = robots_.back()->robotIndex();
@@ -290,6 +303,7 @@ void Robots::rename(const std::string & oldName, const std::string & newName)
   {
     mc_rtc::log::error_and_throw("Cannot rename robot: a robot named {} already exist", newName);
   }
+  generation_++;
   auto index = robotNameToIndex_[oldName];
   robotNameToIndex_.erase(oldName);
   robotNameToIndex_[newName] = index;
@@ -395,7 +409,12 @@ mc_rbdyn::Robots::size_type mc_rbdyn::Robots::size() const noexcept
 
 const RobotModule & Robots::robotModule(size_t idx) const
 {
-  return robot_modules_[idx];
+  return *robot_modules_[idx];
+}
+
+const std::vector<ConstRobotModulePtr> & Robots::robotModules() const
+{
+  return robot_modules_;
 }
 
 MC_RTC_diagnostic_pop
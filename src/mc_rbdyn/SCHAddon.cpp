@@ -4,12 +4,272 @@
 
 #include <mc_rbdyn/SCHAddon.h>
 
+#include <mc_rtc/logging.h>
+
+#include <boost/filesystem.hpp>
+namespace bfs = boost::filesystem;
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef _WIN32
+#  include <sys/stat.h>
+#endif
+
 namespace sch
 {
 
 namespace mc_rbdyn
 {
 
+namespace
+{
+
+/** Version of a polyhedron file */
+struct PolyhedronSource
+{
+  /** Modification time in nanoseconds (in seconds on Windows) */
+  int64_t mtime = 0;
+  uint64_t size = 0;
+
+  bool operator==(const PolyhedronSource & rhs) const noexcept
+  {
+    return mtime == rhs.mtime && size == rhs.size;
+  }
+};
+
+struct PolyhedronCache
+{
+  std::mutex mutex;
+  /** On-disk cache directory, disabled if empty */
+  std::string directory;
+  /** Parsed polyhedra and the version of the file they were parsed from */
+  std::unordered_map<std::string, std::pair<PolyhedronSource, std::shared_ptr<const S_Polyhedron>>> polyhedra;
+};
+
+PolyhedronCache & polyhedronCache()
+{
+  static PolyhedronCache cache;
+  return cache;
+}
+
+/** Get the version of \p filename, returns false if the file cannot be accessed
+ *
+ * boost::filesystem::last_write_time only has a one second resolution so a file modified twice in the same second
+ * with the same size would be considered unchanged, the nanoseconds timestamp is used where it is available
+ */
+bool polyhedronSource(const std::string & filename, PolyhedronSource & source)
+{
+#ifndef _WIN32
+  struct stat st;
+  if(stat(filename.c_str(), &st) != 0)
+  {
+    return false;
+  }
+#  ifdef __APPLE__
+  const auto & mtime = st.st_mtimespec;
+#  else
+  const auto & mtime = st.st_mtim;
+#  endif
+  source.mtime = static_cast<int64_t>(mtime.tv_sec) * 1000000000 + static_cast<int64_t>(mtime.tv_nsec);
+  source.size = static_cast<uint64_t>(st.st_size);
+  return true;
+#else
+  boost::system::error_code ec;
+  source.mtime = static_cast<int64_t>(bfs::last_write_time(filename, ec));
+  if(!ec)
+  {
+    source.size = static_cast<uint64_t>(bfs::file_size(filename, ec));
+  }
+  return !ec;
+#endif
+}
+
+/** Binary format:
+ *
+ * - header: magic, version, source (mtime, size), source path
+ * - vertices: count, then for each vertex: coordinates, neighbors count, neighbors indices
+ * - triangles: count, then for each triangle: vertices indices, normal
+ */
+constexpr char binaryMagic[4] = {'S', 'C', 'H', 'P'};
+constexpr uint8_t binaryVersion = 2;
+
+std::string binaryPath(const std::string & directory, const std::string & filename)
+{
+  return (bfs::path(directory) / fmt::format("{:016x}.bin", std::hash<std::string>{}(filename))).string();
+}
+
+template<typename T>
+void write(std::ofstream & ofs, const T & value)
+{
+  ofs.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read(std::ifstream & ifs, T & value)
+{
+  ifs.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return static_cast<bool>(ifs);
+}
+
+void writeBinary(const std::string & path,
+                 const std::string & filename,
+                 const PolyhedronSource & source,
+                 S_Polyhedron & poly)
+{
+  const auto & algo = *poly.getPolyhedronAlgorithm();
+  std::unordered_map<const S_PolyhedronVertex *, uint32_t> indices;
+  for(size_t i = 0; i < algo.vertexes_.size(); ++i)
+  {
+    indices[algo.vertexes_[i]] = static_cast<uint32_t>(i);
+  }
+  // Write to a temporary file first so that concurrent readers never see a partial file
+  auto tmp = bfs::path(path).parent_path() / bfs::unique_path("%%%%-%%%%-%%%%.tmp");
+  {
+    std::ofstream ofs(tmp.string(), std::ofstream::binary);
+    if(!ofs.is_open())
+    {
+      mc_rtc::log::warning("[Polyhedron] Failed to write {} to the polyhedron cache", filename);
+      return;
+    }
+    ofs.write(binaryMagic, sizeof(binaryMagic));
+    write(ofs, binaryVersion);
+    write(ofs, source.mtime);
+    write(ofs, source.size);
+    write(ofs, static_cast<uint64_t>(filename.size()));
+    ofs.write(filename.data(), static_cast<std::streamsize>(filename.size()));
+    write(ofs, static_cast<uint32_t>(algo.vertexes_.size()));
+    for(const auto * v : algo.vertexes_)
+    {
+      const auto & c = v->getCoordinates();
+      write(ofs, c[0]);
+      write(ofs, c[1]);
+      write(ofs, c[2]);
+      write(ofs, static_cast<uint32_t>(v->getNumNeighbors()));
+      for(unsigned int i = 0; i < v->getNumNeighbors(); ++i)
+      {
+        write(ofs, indices.at(v->getNeighbor(i)));
+      }
+    }
+    write(ofs, static_cast<uint32_t>(algo.triangles_.size()));
+    for(const auto & t : algo.triangles_)
+    {
+      write(ofs, static_cast<uint32_t>(t.a));
+      write(ofs, static_cast<uint32_t>(t.b));
+      write(ofs, static_cast<uint32_t>(t.c));
+      write(ofs, t.normal[0]);
+      write(ofs, t.normal[1]);
+      write(ofs, t.normal[2]);
+    }
+    if(!ofs)
+    {
+      mc_rtc::log::warning("[Polyhedron] Failed to write {} to the polyhedron cache", filename);
+      ofs.close();
+      bfs::remove(tmp);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  bfs::rename(tmp, path, ec);
+  if(ec)
+  {
+    bfs::remove(tmp, ec);
+  }
+}
+
+/** Returns nullptr if the file does not exist or does not match the source */
+std::shared_ptr<S_Polyhedron> readBinary(const std::string & path,
+                                         const std::string & filename,
+                                         const PolyhedronSource & source)
+{
+  std::ifstream ifs(path, std::ifstream::binary);
+  if(!ifs.is_open())
+  {
+    return nullptr;
+  }
+  char magic[sizeof(binaryMagic)];
+  uint8_t version = 0;
+  PolyhedronSource fileSource;
+  uint64_t filenameSize = 0;
+  if(!ifs.read(magic, sizeof(magic)) || memcmp(magic, binaryMagic, sizeof(magic)) != 0 || !read(ifs, version)
+     || version != binaryVersion || !read(ifs, fileSource.mtime) || !read(ifs, fileSource.size)
+     || !(fileSource == source) || !read(ifs, filenameSize) || filenameSize != filename.size())
+  {
+    return nullptr;
+  }
+  std::string fileFilename(filenameSize, '\0');
+  if(!ifs.read(&fileFilename[0], static_cast<std::streamsize>(filenameSize)) || fileFilename != filename)
+  {
+    return nullptr;
+  }
+  auto poly = std::make_shared<S_Polyhedron>();
+  auto & algo = *poly->getPolyhedronAlgorithm();
+  uint32_t nVertices = 0;
+  if(!read(ifs, nVertices))
+  {
+    return nullptr;
+  }
+  std::vector<std::vector<uint32_t>> neighbors(nVertices);
+  algo.vertexes_.reserve(nVertices);
+  for(uint32_t i = 0; i < nVertices; ++i)
+  {
+    double x, y, z;
+    uint32_t nNeighbors = 0;
+    if(!read(ifs, x) || !read(ifs, y) || !read(ifs, z) || !read(ifs, nNeighbors) || nNeighbors > nVertices)
+    {
+      return nullptr;
+    }
+    auto v = new S_PolyhedronVertex();
+    v->setCoordinates(x, y, z);
+    v->setNumber(i);
+    algo.vertexes_.push_back(v);
+    neighbors[i].resize(nNeighbors);
+    for(auto & n : neighbors[i])
+    {
+      if(!read(ifs, n) || n >= nVertices)
+      {
+        return nullptr;
+      }
+    }
+  }
+  for(uint32_t i = 0; i < nVertices; ++i)
+  {
+    for(auto n : neighbors[i])
+    {
+      algo.vertexes_[i]->addNeighbor(algo.vertexes_[n]);
+    }
+    algo.vertexes_[i]->updateFastArrays();
+  }
+  uint32_t nTriangles = 0;
+  if(!read(ifs, nTriangles))
+  {
+    return nullptr;
+  }
+  algo.triangles_.reserve(nTriangles);
+  for(uint32_t i = 0; i < nTriangles; ++i)
+  {
+    uint32_t a, b, c;
+    double normal[3];
+    if(!read(ifs, a) || !read(ifs, b) || !read(ifs, c) || !read(ifs, normal[0]) || !read(ifs, normal[1])
+       || !read(ifs, normal[2]) || a >= nVertices || b >= nVertices || c >= nVertices)
+    {
+      return nullptr;
+    }
+    sch::PolyhedronTriangle t;
+    t.a = a;
+    t.b = b;
+    t.c = c;
+    t.normal.Set(normal);
+    algo.triangles_.push_back(t);
+  }
+  poly->updateFastArrays();
+  return poly;
+}
+
+} // namespace
+
 void transform(S_Object & obj, const sva::PTransformd & t)
 {
   sch::Matrix4x4 m;
@@ -40,9 +300,89 @@ STP_BV * STPBV(const std::string & filename)
 
 S_Polyhedron * Polyhedron(const std::string & filename)
 {
-  S_Polyhedron * s = new S_Polyhedron;
-  s->constructFromFile(filename);
-  return s;
+  auto & cache = polyhedronCache();
+  PolyhedronSource source;
+  if(!polyhedronSource(filename, source))
+  {
+    // Let sch-core handle the error
+    S_Polyhedron * s = new S_Polyhedron;
+    s->constructFromFile(filename);
+    return s;
+  }
+  std::shared_ptr<const S_Polyhedron> prototype = nullptr;
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.polyhedra.find(filename);
+    if(it != cache.polyhedra.end() && it->second.first == source)
+    {
+      prototype = it->second.second;
+    }
+    directory = cache.directory;
+  }
+  if(prototype)
+  {
+    return new S_Polyhedron(*prototype);
+  }
+  // The file is parsed without holding the lock, concurrent loads of the same file might both parse it
+  std::shared_ptr<S_Polyhedron> poly = nullptr;
+  std::string binary;
+  if(directory.size())
+  {
+    binary = binaryPath(directory, filename);
+    poly = readBinary(binary, filename, source);
+  }
+  if(!poly)
+  {
+    poly = std::make_shared<S_Polyhedron>();
+    poly->constructFromFile(filename);
+    if(binary.size())
+    {
+      writeBinary(binary, filename, source, *poly);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.polyhedra[filename] = {source, poly};
+  }
+  return new S_Polyhedron(*poly);
+}
+
+void setPolyhedronCacheDirectory(const std::string & directory)
+{
+  if(directory.size())
+  {
+    boost::system::error_code ec;
+    bfs::create_directories(directory, ec);
+    if(ec)
+    {
+      mc_rtc::log::warning("[Polyhedron] Failed to create the polyhedron cache directory {}: {}", directory,
+                           ec.message());
+      return;
+    }
+  }
+  auto & cache = polyhedronCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.directory = directory;
+}
+
+void clearPolyhedronCache()
+{
+  auto & cache = polyhedronCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.polyhedra.clear();
+}
+
+void clearPolyhedronCache(const std::string & filename)
+{
+  auto & cache = polyhedronCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.polyhedra.erase(filename);
+  if(cache.directory.size())
+  {
+    boost::system::error_code ec;
+    bfs::remove(binaryPath(cache.directory, filename), ec);
+  }
 }
 
 double distance(CD_Pair & pair, Eigen::Vector3d & p1, Eigen::Vector3d & p2)
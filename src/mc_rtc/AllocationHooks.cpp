@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+/** Replacement of the glibc allocation functions that reports the calls to mc_rtc::alloc
+ *
+ * This is built as a separate library (mc_rtc_alloc_hooks) that must be linked into the executable or preloaded, see
+ * mc_rtc/AllocationTracker.h. C++ allocations go through malloc/free in libstdc++ so they are also observed.
+ *
+ * Every allocation entry point of glibc is replaced: malloc, calloc, realloc, reallocarray, memalign, aligned_alloc,
+ * posix_memalign, valloc and pvalloc. Memory obtained by other means (e.g. mmap or sbrk) is not tracked.
+ */
+
+#include <mc_rtc/AllocationTracker.h>
+
+#include <cerrno>
+#include <cstdlib>
+
+extern "C"
+{
+  void * __libc_malloc(size_t size);
+  void * __libc_calloc(size_t n, size_t size);
+  void * __libc_realloc(void * ptr, size_t size);
+  void * __libc_memalign(size_t alignment, size_t size);
+  void * __libc_valloc(size_t size);
+  void * __libc_pvalloc(size_t size);
+  void __libc_free(void * ptr);
+}
+
+#define MC_RTC_ALLOC_HOOK extern "C" __attribute__((visibility("default")))
+
+namespace detail = mc_rtc::alloc::detail;
+
+MC_RTC_ALLOC_HOOK void * malloc(size_t size) noexcept
+{
+  detail::onAllocation(size);
+  return __libc_malloc(size);
+}
+
+MC_RTC_ALLOC_HOOK void * calloc(size_t n, size_t size) noexcept
+{
+  detail::onAllocation(n * size);
+  return __libc_calloc(n, size);
+}
+
+MC_RTC_ALLOC_HOOK void * realloc(void * ptr, size_t size) noexcept
+{
+  detail::onAllocation(size);
+  return __libc_realloc(ptr, size);
+}
+
+MC_RTC_ALLOC_HOOK void * reallocarray(void * ptr, size_t n, size_t size) noexcept
+{
+  size_t total;
+  if(__builtin_mul_overflow(n, size, &total))
+  {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  detail::onAllocation(total);
+  return __libc_realloc(ptr, total);
+}
+
+MC_RTC_ALLOC_HOOK void * memalign(size_t alignment, size_t size) noexcept
+{
+  detail::onAllocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+MC_RTC_ALLOC_HOOK void * aligned_alloc(size_t alignment, size_t size) noexcept
+{
+  detail::onAllocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+MC_RTC_ALLOC_HOOK void * valloc(size_t size) noexcept
+{
+  detail::onAllocation(size);
+  return __libc_valloc(size);
+}
+
+MC_RTC_ALLOC_HOOK void * pvalloc(size_t size) noexcept
+{
+  detail::onAllocation(size);
+  return __libc_pvalloc(size);
+}
+
+MC_RTC_ALLOC_HOOK int posix_memalign(void ** ptr, size_t alignment, size_t size) noexcept
+{
+  if(alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+  {
+    return EINVAL;
+  }
+  detail::onAllocation(size);
+  void * out = __libc_memalign(alignment, size);
+  if(!out)
+  {
+    return ENOMEM;
+  }
+  *ptr = out;
+  return 0;
+}
+
+MC_RTC_ALLOC_HOOK void free(void * ptr) noexcept
+{
+  if(ptr)
+  {
+    detail::onDeallocation();
+  }
+  __libc_free(ptr);
+}
+
+namespace
+{
+
+struct InstallHooks
+{
+  InstallHooks()
+  {
+    detail::installHooks();
+  }
+} install_hooks;
+
+} // namespace
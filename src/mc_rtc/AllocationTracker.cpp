@@ -0,0 +1,297 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/AllocationTracker.h>
+
+#include <mc_rtc/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace mc_rtc
+{
+
+namespace alloc
+{
+
+namespace
+{
+
+/** Everything below is constant-initialized: the hooks might be called before the static initialization of this
+ * library and the counters must not allocate */
+
+struct StageCounters
+{
+  char name[48];
+  std::atomic<uint64_t> allocations;
+  std::atomic<uint64_t> deallocations;
+  std::atomic<uint64_t> bytes;
+};
+
+/** Stages beyond this limit are counted in the last stage */
+constexpr size_t maxStages = 64;
+
+constexpr size_t maxStacks = 64;
+
+constexpr size_t maxFrames = 32;
+
+struct StackSample
+{
+  size_t stage;
+  size_t size;
+  size_t frames;
+  boost::stacktrace::frame::native_frame_ptr_t stack[maxFrames];
+};
+
+std::atomic<bool> hooks_installed{false};
+std::atomic<bool> tracking_enabled{false};
+std::atomic<size_t> stacks_requested{0};
+
+std::array<StageCounters, maxStages> stages;
+std::atomic<size_t> nstages{0};
+/** Protects the registration of new stages */
+std::mutex stages_mutex;
+
+std::array<StackSample, maxStacks> samples;
+/** Number of samples that were reserved (might exceed maxStacks) */
+std::atomic<size_t> nsamples{0};
+/** Number of samples that were fully written */
+std::atomic<size_t> nsamples_ready{0};
+
+/** Stage of the innermost scope on this thread */
+thread_local const char * current_stage = nullptr;
+
+/** Set while an allocation is being recorded, the capture of stacks might allocate */
+thread_local bool in_hook = false;
+
+/** Index of \p name in stages, registers it if needed */
+size_t stageIndex(const char * name) noexcept
+{
+  auto match = [&](size_t i) { return std::strncmp(stages[i].name, name, sizeof(stages[i].name) - 1) == 0; };
+  size_t n = nstages.load(std::memory_order_acquire);
+  for(size_t i = 0; i < n; ++i)
+  {
+    if(match(i))
+    {
+      return i;
+    }
+  }
+  std::unique_lock<std::mutex> lock(stages_mutex);
+  n = nstages.load(std::memory_order_relaxed);
+  for(size_t i = 0; i < n; ++i)
+  {
+    if(match(i))
+    {
+      return i;
+    }
+  }
+  if(n == maxStages)
+  {
+    return maxStages - 1;
+  }
+  auto & stage = stages[n];
+  std::strncpy(stage.name, name, sizeof(stage.name) - 1);
+  stage.name[sizeof(stage.name) - 1] = 0;
+  stage.allocations.store(0, std::memory_order_relaxed);
+  stage.deallocations.store(0, std::memory_order_relaxed);
+  stage.bytes.store(0, std::memory_order_relaxed);
+  nstages.store(n + 1, std::memory_order_release);
+  return n;
+}
+
+/** RAII guard for in_hook */
+struct HookGuard
+{
+  HookGuard() noexcept
+  {
+    in_hook = true;
+  }
+  ~HookGuard() noexcept
+  {
+    in_hook = false;
+  }
+};
+
+bool tracking() noexcept
+{
+  return current_stage && !in_hook && tracking_enabled.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+bool available() noexcept
+{
+  return hooks_installed.load(std::memory_order_relaxed);
+}
+
+bool enabled() noexcept
+{
+  return tracking_enabled.load(std::memory_order_relaxed);
+}
+
+void enable(bool enabled) noexcept
+{
+  if(enabled && !available())
+  {
+    log::warning("[mc_rtc::alloc] Allocations cannot be tracked: the mc_rtc_alloc_hooks library is not loaded");
+    return;
+  }
+  tracking_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void captureStacks(size_t n) noexcept
+{
+  if(n != 0)
+  {
+    // The first capture loads the unwinder which allocates
+    boost::stacktrace::frame::native_frame_ptr_t stack[maxFrames];
+    boost::stacktrace::safe_dump_to(stack, sizeof(stack));
+  }
+  stacks_requested.store(std::min(n, maxStacks), std::memory_order_relaxed);
+}
+
+uint64_t allocations() noexcept
+{
+  uint64_t out = 0;
+  size_t n = nstages.load(std::memory_order_acquire);
+  for(size_t i = 0; i < n; ++i)
+  {
+    out += stages[i].allocations.load(std::memory_order_relaxed);
+  }
+  return out;
+}
+
+std::vector<StageStatistics> statistics()
+{
+  std::vector<StageStatistics> out;
+  size_t n = nstages.load(std::memory_order_acquire);
+  for(size_t i = 0; i < n; ++i)
+  {
+    const auto & stage = stages[i];
+    StageStatistics stats;
+    stats.allocations = stage.allocations.load(std::memory_order_relaxed);
+    stats.deallocations = stage.deallocations.load(std::memory_order_relaxed);
+    stats.bytes = stage.bytes.load(std::memory_order_relaxed);
+    if(stats.allocations != 0 || stats.deallocations != 0)
+    {
+      stats.name = stage.name;
+      out.push_back(stats);
+    }
+  }
+  return out;
+}
+
+std::vector<Allocation> stacks()
+{
+  std::vector<Allocation> out;
+  size_t n = std::min(nsamples_ready.load(std::memory_order_acquire), maxStacks);
+  for(size_t i = 0; i < n; ++i)
+  {
+    const auto & sample = samples[i];
+    auto trace = boost::stacktrace::stacktrace::from_dump(sample.stack, sample.frames * sizeof(sample.stack[0]));
+    out.push_back({stages[sample.stage].name, sample.size, boost::stacktrace::to_string(trace)});
+  }
+  return out;
+}
+
+void reset() noexcept
+{
+  size_t n = nstages.load(std::memory_order_acquire);
+  for(size_t i = 0; i < n; ++i)
+  {
+    stages[i].allocations.store(0, std::memory_order_relaxed);
+    stages[i].deallocations.store(0, std::memory_order_relaxed);
+    stages[i].bytes.store(0, std::memory_order_relaxed);
+  }
+  nsamples_ready.store(0, std::memory_order_relaxed);
+  nsamples.store(0, std::memory_order_release);
+}
+
+void report()
+{
+  if(!available())
+  {
+    log::warning("[mc_rtc::alloc] Allocations are not tracked: the mc_rtc_alloc_hooks library is not loaded");
+    return;
+  }
+  auto stats = statistics();
+  if(stats.empty())
+  {
+    log::success("[mc_rtc::alloc] No allocation");
+    return;
+  }
+  for(const auto & s : stats)
+  {
+    log::warning("[mc_rtc::alloc] {}: {} allocations ({} bytes), {} deallocations", s.name, s.allocations, s.bytes,
+                 s.deallocations);
+  }
+  for(const auto & a : stacks())
+  {
+    log::info("[mc_rtc::alloc] Allocation of {} bytes in {}:\n{}", a.size, a.stage, a.stack);
+  }
+}
+
+Scope::Scope(const char * stage) noexcept : previous_(current_stage)
+{
+  current_stage = stage;
+}
+
+Scope::~Scope() noexcept
+{
+  current_stage = previous_;
+}
+
+namespace detail
+{
+
+void installHooks() noexcept
+{
+  hooks_installed.store(true, std::memory_order_relaxed);
+  tracking_enabled.store(true, std::memory_order_relaxed);
+}
+
+void onAllocation(size_t size) noexcept
+{
+  if(!tracking())
+  {
+    return;
+  }
+  HookGuard guard;
+  size_t idx = stageIndex(current_stage);
+  auto & stage = stages[idx];
+  stage.allocations.fetch_add(1, std::memory_order_relaxed);
+  stage.bytes.fetch_add(size, std::memory_order_relaxed);
+  if(nsamples.load(std::memory_order_relaxed) < stacks_requested.load(std::memory_order_relaxed))
+  {
+    size_t i = nsamples.fetch_add(1, std::memory_order_relaxed);
+    if(i < stacks_requested.load(std::memory_order_relaxed))
+    {
+      auto & sample = samples[i];
+      sample.stage = idx;
+      sample.size = size;
+      // Skip this function and the hook
+      sample.frames = boost::stacktrace::safe_dump_to(2, sample.stack, sizeof(sample.stack));
+      nsamples_ready.fetch_add(1, std::memory_order_release);
+    }
+  }
+}
+
+void onDeallocation() noexcept
+{
+  if(!tracking())
+  {
+    return;
+  }
+  HookGuard guard;
+  stages[stageIndex(current_stage)].deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+} // namespace alloc
+
+} // namespace mc_rtc
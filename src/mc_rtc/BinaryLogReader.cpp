@@ -0,0 +1,354 @@
+/*
+ * Copyright 2015-2021 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/log/BinaryLogReader.h>
+#include <mc_rtc/log/Logger.h>
+
+#include <boost/filesystem.hpp>
+namespace bfs = boost::filesystem;
+
+#include "internals/LogEntry.h"
+#include "internals/LogIndex.h"
+#include <fstream>
+
+namespace mc_rtc
+{
+
+namespace log
+{
+
+struct BinaryLogReaderImpl
+{
+  BinaryLogReaderImpl(const std::string & f, const std::string & time) : path_(f), time_(time), buffer_(1024)
+  {
+    if(!bfs::exists(f) || !bfs::is_regular(f))
+    {
+      log::error("Could not open log {}, file does not exist", f);
+      return;
+    }
+    ifs_.open(f, std::ifstream::binary);
+    if(!ifs_.is_open())
+    {
+      log::error("Failed to open {}", f);
+      return;
+    }
+    ifs_.read(buffer_.data(), sizeof(mc_rtc::Logger::magic));
+    if(!ifs_ || memcmp(buffer_.data(), &mc_rtc::Logger::magic, sizeof(mc_rtc::Logger::magic) - 1) != 0)
+    {
+      log::error("Log {} is not a valid mc_rtc binary log (Invalid magic number)", f);
+      return;
+    }
+    version_ = static_cast<int8_t>(buffer_.data()[sizeof(mc_rtc::Logger::magic) - 1] - mc_rtc::Logger::magic[3]);
+    if(version_ < 0)
+    {
+      log::error("Log {} is not a valid mc_rtc binary log (Invalid version number)", f);
+      return;
+    }
+    if(version_ > mc_rtc::Logger::version)
+    {
+      log::error("Log {} cannot be read by this version of mc_rtc ({} > {})", f, version_, mc_rtc::Logger::version);
+      return;
+    }
+    file_size_ = bfs::file_size(f);
+    offset_ = sizeof(mc_rtc::Logger::magic);
+    valid_ = true;
+  }
+
+  /** Read the next frame, returns false at the end of the log or if an error occured */
+  bool read(bool extract)
+  {
+    entry_.reset();
+    pending_ = false;
+    uint64_t entrySize = 0;
+    ifs_.read((char *)&entrySize, sizeof(uint64_t));
+    if(!ifs_)
+    {
+      return false;
+    }
+    while(buffer_.size() < entrySize)
+    {
+      buffer_.resize(2 * buffer_.size());
+    }
+    ifs_.read(buffer_.data(), static_cast<int>(entrySize));
+    if(!ifs_)
+    {
+      return false;
+    }
+    frame_offset_ = offset_;
+    offset_ += sizeof(uint64_t) + entrySize;
+    entry_size_ = entrySize;
+    keys_changed_ = false;
+    entry_.emplace(version_, buffer_.data(), entrySize, keys_, keys_changed_, extract);
+    if(!entry_->valid())
+    {
+      error_ = true;
+      return false;
+    }
+    iteration_++;
+    if(keys_changed_ && time_.size())
+    {
+      auto t_it = std::find_if(keys_.begin(), keys_.end(), [&](const auto & k) { return k.key == time_; });
+      if(t_it == keys_.end())
+      {
+        log::error("Request time key: {} not found in log", time_);
+        error_ = true;
+        return false;
+      }
+      if(t_it->type != LogType::Double)
+      {
+        log::error("Time key: {} not recording double", time_);
+        error_ = true;
+        return false;
+      }
+      t_index_ = static_cast<size_t>(std::distance(keys_.begin(), t_it));
+    }
+    return true;
+  }
+
+  /** Time of the current frame */
+  double t()
+  {
+    return time_.size() ? entry_->getTime(t_index_) : -1;
+  }
+
+  /** Index of the current frame */
+  size_t current() const
+  {
+    return iteration_ - 1;
+  }
+
+  /** Move to a checkpoint then read frames until \p done returns true */
+  template<typename Callback>
+  bool seek(const internal::LogCheckpoint & checkpoint, Callback && done)
+  {
+    entry_.reset();
+    ifs_.clear();
+    ifs_.seekg(static_cast<std::streamoff>(checkpoint.offset));
+    offset_ = checkpoint.offset;
+    iteration_ = checkpoint.iteration;
+    keys_.clear();
+    error_ = false;
+    while(read(false))
+    {
+      if(done())
+      {
+        // The frame is provided by the next call to iterate
+        pending_ = true;
+        new_keys_ = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Load the index or rebuild it if it is not available */
+  bool load_index()
+  {
+    if(index_)
+    {
+      return true;
+    }
+    internal::LogIndex index;
+    if(index.load(BinaryLogReader::index_path(path_)) && index.log_size == file_size_ && index.checkpoints.size()
+       && index.checkpoints[0].iteration == 0)
+    {
+      index_ = std::move(index);
+      return true;
+    }
+    // Rebuild the index by reading the whole log
+    size_t iteration = pending_ ? current() : iteration_;
+    index = {};
+    if(!seek({sizeof(mc_rtc::Logger::magic), 0, 0.0}, [&]() {
+         if(current() == 0 || entry_->checkpoint())
+         {
+           index.checkpoints.push_back({frame_offset_, current(), t()});
+         }
+         return false;
+       })
+       && error_)
+    {
+      return false;
+    }
+    index.frames = iteration_;
+    index.log_size = offset_;
+    index_ = std::move(index);
+    // Go back to the previous position
+    if(iteration < index_->frames)
+    {
+      return seekIteration(iteration);
+    }
+    return true;
+  }
+
+  bool seekIteration(size_t iteration)
+  {
+    if(!valid_ || !load_index() || iteration >= index_->frames)
+    {
+      return false;
+    }
+    const auto & checkpoints = index_->checkpoints;
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), iteration,
+                               [](size_t i, const internal::LogCheckpoint & c) { return i < c.iteration; });
+    return seek(*std::prev(it), [&]() { return current() == iteration; });
+  }
+
+  bool seekTime(double t)
+  {
+    if(time_.empty())
+    {
+      log::error("Cannot seek in {} without a time key", path_);
+      return false;
+    }
+    if(!valid_ || !load_index() || index_->checkpoints.empty())
+    {
+      return false;
+    }
+    const auto & checkpoints = index_->checkpoints;
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), t,
+                               [](double t, const internal::LogCheckpoint & c) { return t < c.t; });
+    if(it != checkpoints.begin())
+    {
+      --it;
+    }
+    return seek(*it, [&]() { return this->t() >= t; });
+  }
+
+  bool iterate(const binary_log_copy_callback & callback, bool extract)
+  {
+    if(!valid_)
+    {
+      return false;
+    }
+    auto deliver = [&]() {
+      if(extract)
+      {
+        entry_->extract();
+      }
+      std::vector<std::string> keys_str;
+      if(keys_changed_ || new_keys_)
+      {
+        keys_str.reserve(keys_.size());
+        for(const auto & k : keys_)
+        {
+          keys_str.push_back(k.key);
+        }
+      }
+      new_keys_ = false;
+      auto & log = *entry_;
+      return callback(
+          keys_str, log.records(), t(),
+          [&log](mc_rtc::MessagePackBuilder & builder, const std::vector<std::string> & keys) {
+            log.copy(builder, keys);
+          },
+          buffer_.data(), entry_size_);
+    };
+    if(pending_)
+    {
+      pending_ = false;
+      if(!deliver())
+      {
+        return false;
+      }
+    }
+    while(read(extract))
+    {
+      if(!deliver())
+      {
+        return false;
+      }
+    }
+    return !error_;
+  }
+
+  std::string path_;
+  std::string time_;
+  bool valid_ = false;
+  int8_t version_ = 0;
+  std::ifstream ifs_;
+  uint64_t file_size_ = 0;
+  std::vector<char> buffer_;
+  /** Keys (and last values) of the current frame */
+  std::vector<internal::TypedKey> keys_;
+  /** Current frame */
+  std::optional<internal::LogEntry> entry_;
+  /** Size of the current frame */
+  uint64_t entry_size_ = 0;
+  /** Offset of the current frame */
+  uint64_t frame_offset_ = 0;
+  /** Offset of the next frame */
+  uint64_t offset_ = 0;
+  /** Index of the next frame */
+  size_t iteration_ = 0;
+  /** True if the keys changed in the current frame */
+  bool keys_changed_ = false;
+  /** True if the current frame was read by a seek and should be provided by the next iterate call */
+  bool pending_ = false;
+  /** True if the keys should be provided with the next frame */
+  bool new_keys_ = false;
+  /** True if an error occured while reading the log */
+  bool error_ = false;
+  /** Index of the time key */
+  size_t t_index_ = 0;
+  /** Index of the log, loaded on demand */
+  std::optional<internal::LogIndex> index_;
+};
+
+BinaryLogReader::BinaryLogReader(const std::string & fpath, const std::string & time)
+: impl_(new BinaryLogReaderImpl(fpath, time))
+{
+}
+
+BinaryLogReader::~BinaryLogReader() {}
+
+bool BinaryLogReader::valid() const
+{
+  return impl_->valid_;
+}
+
+size_t BinaryLogReader::size()
+{
+  if(!impl_->valid_ || !impl_->load_index())
+  {
+    return 0;
+  }
+  return impl_->index_->frames;
+}
+
+size_t BinaryLogReader::iteration() const
+{
+  return impl_->pending_ ? impl_->current() : impl_->iteration_;
+}
+
+bool BinaryLogReader::seek(double t)
+{
+  return impl_->seekTime(t);
+}
+
+bool BinaryLogReader::seekIteration(size_t iteration)
+{
+  return impl_->seekIteration(iteration);
+}
+
+bool BinaryLogReader::iterate(const binary_log_copy_callback & callback, bool extract)
+{
+  return impl_->iterate(callback, extract);
+}
+
+bool BinaryLogReader::iterate(const binary_log_callback & callback, bool extract)
+{
+  return impl_->iterate(
+      binary_log_copy_callback([&callback](const std::vector<std::string> & keys, std::vector<FlatLog::record> & data,
+                                           double t, const copy_callback &, const char *,
+                                           size_t) mutable { return callback(keys, data, t); }),
+      extract);
+}
+
+std::string BinaryLogReader::index_path(const std::string & fpath)
+{
+  return fpath + ".idx";
+}
+
+} // namespace log
+
+} // namespace mc_rtc
@@ -5,6 +5,7 @@
 #include <mc_rbdyn/rpy_utils.h>
 #include <mc_rtc/Configuration.h>
 #include <mc_rtc/logging.h>
+#include <mc_rtc/version.h>
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/filesystem.hpp>
@@ -12,8 +13,15 @@ namespace bfs = boost::filesystem;
 
 #include "internals/json.h"
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 
+#ifndef _WIN32
+#  include <sys/stat.h>
+#endif
+
 namespace
 {
 inline std::string to_lower(const std::string & in)
@@ -184,7 +192,7 @@ const std::string & Configuration::Exception::msg() const noexcept
   return msg_;
 }
 
-Configuration::Configuration() : v{nullptr, std::shared_ptr<void>(new internal::RapidJSONDocument())}
+Configuration::Configuration() : v{nullptr, std::make_shared<internal::RapidJSONDocument>()}
 {
   auto doc = std::static_pointer_cast<internal::RapidJSONDocument>(v.doc_);
   auto value = rapidjson::GenericPointer<internal::RapidJSONValue>("/").Get(*doc);
@@ -701,6 +709,345 @@ Configuration Configuration::fromMessagePack(const char * data, size_t size)
   return config;
 }
 
+namespace
+{
+
+/** Memory used by Configuration::ScratchData */
+struct ScratchState
+{
+  /** Size of the buffer allocated on the first use */
+  static constexpr size_t default_size = 4096;
+  /** Initial capacity of the parsing stack, it is allocated from the buffer as well */
+  static constexpr size_t stack_capacity = 1024;
+  /** Buffer used by the scratch allocator, it grows to hold the largest data parsed so far */
+  std::unique_ptr<char[]> buffer;
+  size_t size = 0;
+  /** Allocator of the chunks beyond the buffer */
+  rapidjson::CrtAllocator base;
+  std::optional<internal::RapidJSONScratchAllocator> allocator;
+  std::optional<internal::RapidJSONScratchDocument> document;
+  /** True while a ScratchData uses this state */
+  bool in_use = false;
+  /** True if this state belongs to a single ScratchData */
+  bool owned = false;
+
+  void load(const char * data)
+  {
+    in_use = true;
+    if(!buffer)
+    {
+      size = default_size;
+      buffer.reset(new char[size]);
+    }
+    allocator.emplace(buffer.get(), size, default_size, &base);
+    document.emplace(&*allocator, stack_capacity, &*allocator);
+    internal::loadData(data, *document);
+  }
+
+  void release()
+  {
+    // The buffer will hold everything the next time if the allocator had to allocate more chunks
+    size_t capacity = allocator->Capacity();
+    document.reset();
+    allocator.reset();
+    if(capacity > size)
+    {
+      size = capacity;
+      buffer.reset(new char[size]);
+    }
+    in_use = false;
+  }
+};
+
+ScratchState & scratchState()
+{
+  static thread_local ScratchState state;
+  return state;
+}
+
+} // namespace
+
+Configuration::ScratchData::ScratchData(const char * data)
+{
+  auto * state = &scratchState();
+  if(state->in_use)
+  {
+    state = new ScratchState();
+    state->owned = true;
+  }
+  state->load(data);
+  impl_ = state;
+}
+
+Configuration::ScratchData::~ScratchData()
+{
+  auto * state = static_cast<ScratchState *>(impl_);
+  state->release();
+  if(state->owned)
+  {
+    delete state;
+  }
+}
+
+bool Configuration::ScratchData::valid() const noexcept
+{
+  const auto & doc = *static_cast<const ScratchState *>(impl_)->document;
+  return !doc.HasParseError() && doc.IsObject();
+}
+
+bool Configuration::ScratchData::read(const char * key, std::string & out) const
+{
+  if(!valid())
+  {
+    return false;
+  }
+  const auto & doc = *static_cast<const ScratchState *>(impl_)->document;
+  auto it = doc.FindMember(key);
+  if(it == doc.MemberEnd() || !it->value.IsString())
+  {
+    return false;
+  }
+  out.assign(it->value.GetString(), it->value.GetStringLength());
+  return true;
+}
+
+bool Configuration::ScratchData::read(const char * key, std::vector<std::string> & out) const
+{
+  if(!valid())
+  {
+    return false;
+  }
+  const auto & doc = *static_cast<const ScratchState *>(impl_)->document;
+  auto it = doc.FindMember(key);
+  if(it == doc.MemberEnd() || !it->value.IsArray())
+  {
+    return false;
+  }
+  auto array = it->value.GetArray();
+  for(const auto & v : array)
+  {
+    if(!v.IsString())
+    {
+      return false;
+    }
+  }
+  out.resize(array.Size());
+  for(size_t i = 0; i < out.size(); ++i)
+  {
+    out[i].assign(array[i].GetString(), array[i].GetStringLength());
+  }
+  return true;
+}
+
+Configuration Configuration::ScratchData::copy(const char * key) const
+{
+  Configuration out;
+  if(!valid())
+  {
+    return out;
+  }
+  const auto & doc = *static_cast<const ScratchState *>(impl_)->document;
+  auto it = doc.FindMember(key);
+  if(it == doc.MemberEnd())
+  {
+    return out;
+  }
+  auto & target = *std::static_pointer_cast<internal::RapidJSONDocument>(out.v.doc_);
+  target.CopyFrom(it->value, target.GetAllocator());
+  return out;
+}
+
+namespace
+{
+
+struct YAMLCache
+{
+  std::mutex mutex;
+  /** Cache directory, disabled if empty */
+  std::string directory;
+};
+
+YAMLCache & yamlCache()
+{
+  static YAMLCache cache;
+  return cache;
+}
+
+/** Version of a YAML file */
+struct YAMLSource
+{
+  std::string path;
+  /** Modification time in nanoseconds (in seconds on Windows) */
+  int64_t mtime = 0;
+  uint64_t size = 0;
+};
+
+/** Get the modification time and size of \p path, returns false if the file cannot be accessed
+ *
+ * boost::filesystem::last_write_time only has a one second resolution so a file modified twice in the same second
+ * with the same size would be considered unchanged, the nanoseconds timestamp is used where it is available
+ */
+bool yamlSource(const std::string & path, YAMLSource & source)
+{
+#ifndef _WIN32
+  struct stat st;
+  if(stat(path.c_str(), &st) != 0)
+  {
+    return false;
+  }
+#  ifdef __APPLE__
+  const auto & mtime = st.st_mtimespec;
+#  else
+  const auto & mtime = st.st_mtim;
+#  endif
+  source.mtime = static_cast<int64_t>(mtime.tv_sec) * 1000000000 + static_cast<int64_t>(mtime.tv_nsec);
+  source.size = static_cast<uint64_t>(st.st_size);
+  return true;
+#else
+  boost::system::error_code ec;
+  source.mtime = static_cast<int64_t>(bfs::last_write_time(path, ec));
+  if(!ec)
+  {
+    source.size = static_cast<uint64_t>(bfs::file_size(path, ec));
+  }
+  return !ec;
+#endif
+}
+
+/** Cache entries are MessagePack arrays: [magic, mc_rtc version, path, mtime, size, document] */
+constexpr auto cacheMagic = "mc_rtc::Configuration";
+
+std::string cachePath(const std::string & directory, const YAMLSource & source)
+{
+  return (bfs::path(directory) / fmt::format("{:016x}.msgpack", std::hash<std::string>{}(source.path))).string();
+}
+
+/** Load the cached version of \p source into \p out, returns false if there is no matching cache entry */
+bool loadCachedYAML(const std::string & cache, const YAMLSource & source, internal::RapidJSONDocument & out)
+{
+  std::ifstream ifs(cache, std::ifstream::binary);
+  if(!ifs.is_open())
+  {
+    return false;
+  }
+  std::vector<char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  mpack_tree_t tree;
+  mpack_tree_init_data(&tree, data.data(), data.size());
+  mpack_tree_parse(&tree);
+  auto root = mpack_tree_root(&tree);
+  auto str = [](mpack_node_t node) -> std::string {
+    if(mpack_node_type(node) != mpack_type_str)
+    {
+      return "";
+    }
+    return {mpack_node_str(node), mpack_node_strlen(node)};
+  };
+  bool valid = mpack_tree_error(&tree) == mpack_ok && mpack_node_type(root) == mpack_type_array
+               && mpack_node_array_length(root) == 6 && str(mpack_node_array_at(root, 0)) == cacheMagic
+               && str(mpack_node_array_at(root, 1)) == MC_RTC_VERSION
+               && str(mpack_node_array_at(root, 2)) == source.path
+               && mpack_node_i64(mpack_node_array_at(root, 3)) == source.mtime
+               && mpack_node_u64(mpack_node_array_at(root, 4)) == source.size && mpack_tree_error(&tree) == mpack_ok;
+  if(valid)
+  {
+    internal::RapidJSONValue value;
+    valid = internal::fromMessagePack(mpack_node_array_at(root, 5), value, out.GetAllocator());
+    if(valid)
+    {
+      static_cast<internal::RapidJSONValue &>(out).Swap(value);
+    }
+  }
+  mpack_tree_destroy(&tree);
+  return valid;
+}
+
+void storeCachedYAML(const std::string & cache, const YAMLSource & source, const Configuration & config)
+{
+  std::vector<char> data;
+  MessagePackBuilder builder(data);
+  builder.start_array(6);
+  builder.write(cacheMagic);
+  builder.write(MC_RTC_VERSION);
+  builder.write(source.path);
+  builder.write(source.mtime);
+  builder.write(source.size);
+  builder.write(config);
+  builder.finish_array();
+  size_t size = builder.finish();
+  // Write to a temporary file first so that concurrent readers never see a partial file
+  auto tmp = bfs::path(cache).parent_path() / bfs::unique_path("%%%%-%%%%-%%%%.tmp");
+  {
+    std::ofstream ofs(tmp.string(), std::ofstream::binary);
+    if(!ofs.is_open() || !ofs.write(data.data(), static_cast<std::streamsize>(size)))
+    {
+      log::warning("[Configuration] Failed to write {} to the configuration cache", source.path);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  bfs::rename(tmp, cache, ec);
+  if(ec)
+  {
+    bfs::remove(tmp, ec);
+  }
+}
+
+/** Load a YAML file into \p out, through the cache if it is enabled */
+bool loadYAML(const std::string & path, Configuration & out, internal::RapidJSONDocument & target)
+{
+  std::string directory = Configuration::cacheDirectory();
+  if(directory.empty())
+  {
+    return internal::loadYAMLDocument(path, out);
+  }
+  YAMLSource source;
+  source.path = bfs::absolute(path).string();
+  if(!yamlSource(path, source))
+  {
+    // Let the YAML loader report the error
+    return internal::loadYAMLDocument(path, out);
+  }
+  auto cache = cachePath(directory, source);
+  if(loadCachedYAML(cache, source, target))
+  {
+    return true;
+  }
+  target.SetObject();
+  if(!internal::loadYAMLDocument(path, out))
+  {
+    return false;
+  }
+  storeCachedYAML(cache, source, out);
+  return true;
+}
+
+} // namespace
+
+void Configuration::cacheDirectory(const std::string & directory)
+{
+  if(directory.size())
+  {
+    boost::system::error_code ec;
+    bfs::create_directories(directory, ec);
+    if(ec)
+    {
+      log::warning("[Configuration] Failed to create the configuration cache directory {}: {}", directory,
+                   ec.message());
+      return;
+    }
+  }
+  auto & cache = yamlCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.directory = directory;
+}
+
+std::string Configuration::cacheDirectory()
+{
+  auto & cache = yamlCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.directory;
+}
+
 void Configuration::load(const std::string & path)
 {
   auto & target = *std::static_pointer_cast<internal::RapidJSONDocument>(v.doc_);
@@ -711,7 +1058,7 @@ void Configuration::load(const std::string & path)
     if(extension == ".yml" || extension == ".yaml")
     {
       target.SetObject();
-      if(!mc_rtc::internal::loadYAMLDocument(path, *this))
+      if(!loadYAML(path, *this, target))
       {
         log::warning("Configuration dump until the attempted conversion:\n{}", this->dump(true));
       }
@@ -2,6 +2,7 @@
  * Copyright 2015-2019 CNRS-UM LIRMM, CNRS-AIST JRL
  */
 
+#include <mc_rtc/log/BinaryLogReader.h>
 #include <mc_rtc/log/FlatLog.h>
 #include <mc_rtc/log/Logger.h>
 #include <mc_rtc/log/iterate_binary_log.h>
@@ -9,8 +10,16 @@
 #include <boost/filesystem.hpp>
 namespace bfs = boost::filesystem;
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+namespace bip = boost::interprocess;
+
 #include "internals/LogEntry.h"
+#include "internals/LogStorage.h"
+#include <cstring>
 #include <fstream>
+#include <mutex>
+#include <thread>
 
 namespace mc_rtc
 {
@@ -18,21 +27,498 @@ namespace mc_rtc
 namespace log
 {
 
+namespace internal
+{
+
+/** A binary log mapped in memory, used to decode the entries of a lazily loaded FlatLog */
+struct MappedLog
+{
+  /** Key of an entry in a frame */
+  struct Key
+  {
+    LogType type;
+    std::string name;
+
+    bool operator==(const Key & other) const
+    {
+      return type == other.type && name == other.name;
+    }
+  };
+
+  /** Consecutive frames that share the same keys */
+  struct Segment
+  {
+    /** First frame of the segment */
+    size_t start;
+    /** Keys in the order of the frame values */
+    std::vector<Key> keys;
+  };
+
+  bip::file_mapping file;
+  bip::mapped_region region;
+  int8_t version = 0;
+  /** Offset of the data of every frame */
+  std::vector<uint64_t> frames;
+  /** Key changes in the log */
+  std::vector<Segment> segments;
+  /** Frames that hold key events, since version 2 these are the keyframes */
+  std::vector<size_t> events;
+  /** Serialize the decoding of entries on access */
+  std::mutex decode_mutex;
+
+  const char * data() const
+  {
+    return static_cast<const char *>(region.get_address());
+  }
+
+  size_t size() const
+  {
+    return region.get_size();
+  }
+
+  /** Size of the data of a given frame */
+  uint64_t frame_size(size_t frame) const
+  {
+    uint64_t out;
+    std::memcpy(&out, data() + frames[frame] - sizeof(uint64_t), sizeof(uint64_t));
+    return out;
+  }
+
+  /** Segment that holds a given frame */
+  const Segment * segment(size_t frame) const
+  {
+    auto it = std::upper_bound(segments.begin(), segments.end(), frame,
+                               [](size_t f, const Segment & s) { return f < s.start; });
+    return it == segments.begin() ? nullptr : &*std::prev(it);
+  }
+
+  /** Last frame (excluded) of a segment */
+  size_t segment_end(size_t segment) const
+  {
+    return segment + 1 < segments.size() ? segments[segment + 1].start : frames.size();
+  }
+
+  /** Map the log and check its header, returns false on failure */
+  bool open(const std::string & f)
+  {
+    if(!bfs::exists(f) || !bfs::is_regular(f))
+    {
+      log::error("Could not open log {}, file does not exist", f);
+      return false;
+    }
+    if(bfs::file_size(f) < sizeof(mc_rtc::Logger::magic))
+    {
+      log::error("Log {} is not a valid mc_rtc binary log (File too small)", f);
+      return false;
+    }
+    try
+    {
+      file = bip::file_mapping(f.c_str(), bip::read_only);
+      region = bip::mapped_region(file, bip::read_only);
+    }
+    catch(const bip::interprocess_exception & exc)
+    {
+      log::error("Failed to map {}: {}", f, exc.what());
+      return false;
+    }
+    if(memcmp(data(), &mc_rtc::Logger::magic, sizeof(mc_rtc::Logger::magic) - 1) != 0)
+    {
+      log::error("Log {} is not a valid mc_rtc binary log (Invalid magic number)", f);
+      return false;
+    }
+    version = static_cast<int8_t>(data()[sizeof(mc_rtc::Logger::magic) - 1] - mc_rtc::Logger::magic[3]);
+    if(version < 0)
+    {
+      log::error("Log {} is not a valid mc_rtc binary log (Invalid version number)", f);
+      return false;
+    }
+    if(version > mc_rtc::Logger::version)
+    {
+      log::error("Log {} cannot be read by this version of mc_rtc ({} > {})", f, version, mc_rtc::Logger::version);
+      return false;
+    }
+    return true;
+  }
+
+  /** Find the frames and key changes in the log
+   *
+   * Only the frames that hold key events are fully parsed
+   */
+  bool scan()
+  {
+    std::vector<TypedKey> keys;
+    uint64_t offset = sizeof(mc_rtc::Logger::magic);
+    while(offset + sizeof(uint64_t) <= size())
+    {
+      uint64_t entrySize = 0;
+      std::memcpy(&entrySize, data() + offset, sizeof(uint64_t));
+      offset += sizeof(uint64_t);
+      if(entrySize > size() - offset)
+      {
+        // Incomplete frame at the end of the log
+        break;
+      }
+      const char * frame = data() + offset;
+      mpack_reader_t reader;
+      mpack_reader_init_data(&reader, frame, entrySize);
+      bool valid = mpack_expect_array(&reader) == 2;
+      bool has_events = valid && mpack_peek_tag(&reader).type != mpack_type_nil;
+      valid = valid && mpack_reader_error(&reader) == mpack_ok;
+      mpack_reader_flag_error(&reader, mpack_error_data);
+      mpack_reader_destroy(&reader);
+      if(!valid)
+      {
+        log::error("Failed to read frame {} of the log", frames.size());
+        return false;
+      }
+      if(has_events)
+      {
+        events.push_back(frames.size());
+        bool keys_changed = false;
+        LogEntry entry(version, frame, entrySize, keys, keys_changed, false);
+        if(!entry.valid())
+        {
+          return false;
+        }
+        std::vector<Key> segment_keys;
+        segment_keys.reserve(keys.size());
+        for(const auto & k : keys)
+        {
+          segment_keys.push_back({k.type, k.key});
+        }
+        // Keyframes usually repeat the current keys
+        if(segments.empty() || segments.back().keys != segment_keys)
+        {
+          segments.push_back({frames.size(), std::move(segment_keys)});
+        }
+      }
+      frames.push_back(offset);
+      offset += entrySize;
+    }
+    return true;
+  }
+
+  /** Find the value at \p idx in a frame
+   *
+   * Returns nullptr if the frame could not be read, \p remaining holds the size of the data after the value
+   */
+  const char * value(size_t frame, size_t idx, size_t & remaining) const
+  {
+    mpack_reader_t reader;
+    mpack_reader_init_data(&reader, data() + frames[frame], frame_size(frame));
+    const char * out = nullptr;
+    if(mpack_expect_array(&reader) == 2)
+    {
+      // Events
+      mpack_discard(&reader);
+      if(mpack_expect_array(&reader) > idx)
+      {
+        for(size_t i = 0; i < idx; ++i)
+        {
+          mpack_discard(&reader);
+        }
+        remaining = mpack_reader_remaining(&reader, &out);
+      }
+    }
+    if(mpack_reader_error(&reader) != mpack_ok)
+    {
+      out = nullptr;
+    }
+    mpack_reader_flag_error(&reader, mpack_error_data);
+    mpack_reader_destroy(&reader);
+    return out;
+  }
+};
+
+} // namespace internal
+
 FlatLog::record::record() : type(), data(nullptr, internal::void_deleter<int>) {}
 
+FlatLog::FlatLog() = default;
+
 FlatLog::FlatLog(const std::string & fpath)
 {
   load(fpath);
 }
 
+FlatLog::FlatLog(const std::string & fpath, bool lazy)
+{
+  load(fpath, lazy);
+}
+
+FlatLog::~FlatLog() = default;
+
+FlatLog::FlatLog(FlatLog &&) = default;
+
+FlatLog & FlatLog::operator=(FlatLog &&) = default;
+
 void FlatLog::load(const std::string & fpath)
 {
   data_.clear();
+  size_ = 0;
+  mapped_.reset();
   append(fpath);
 }
 
+void FlatLog::load(const std::string & fpath, bool lazy)
+{
+  if(!lazy || bfs::path(fpath).extension() == ".flat")
+  {
+    load(fpath);
+    return;
+  }
+  data_.clear();
+  size_ = 0;
+  mapped_.reset();
+  if(!loadLazy(fpath))
+  {
+    load(fpath);
+  }
+}
+
+void FlatLog::load(const std::string & fpath, double from, double to)
+{
+  data_.clear();
+  size_ = 0;
+  mapped_.reset();
+  appendBin(fpath, from, to);
+}
+
+bool FlatLog::loadLazy(const std::string & f)
+{
+  auto mapped = std::make_unique<internal::MappedLog>();
+  if(!mapped->open(f) || mapped->version < 1 || !mapped->scan())
+  {
+    return false;
+  }
+  size_ = mapped->frames.size();
+  for(const auto & s : mapped->segments)
+  {
+    for(const auto & k : s.keys)
+    {
+      data_[index(k.name)].decoded = false;
+    }
+  }
+  mapped_ = std::move(mapped);
+  return true;
+}
+
+void FlatLog::decode(entry & e) const
+{
+  e.decoded = true;
+  const auto & mapped = *mapped_;
+  std::vector<mpack_node_data_t> nodes;
+  for(size_t s = 0; s < mapped.segments.size(); ++s)
+  {
+    const auto & keys = mapped.segments[s].keys;
+    auto key_it = std::find_if(keys.begin(), keys.end(), [&](const auto & k) { return k.name == e.name; });
+    if(key_it == keys.end())
+    {
+      continue;
+    }
+    size_t idx = static_cast<size_t>(std::distance(keys.begin(), key_it));
+    bool ok = true;
+    internal::visit_storage(key_it->type, [&](auto tag) {
+      using T = typename decltype(tag)::type;
+      auto & c = get_or_add_column<T>(e);
+      c.resize(size_);
+      for(size_t i = mapped.segments[s].start; ok && i < mapped.segment_end(s); ++i)
+      {
+        size_t remaining = 0;
+        const char * value = mapped.value(i, idx, remaining);
+        if(!value)
+        {
+          ok = false;
+          break;
+        }
+        mpack_reader_t reader;
+        mpack_reader_init_data(&reader, value, remaining);
+        auto value_tag = mpack_read_tag(&reader);
+        mpack_reader_flag_error(&reader, mpack_error_data);
+        mpack_reader_destroy(&reader);
+        if(value_tag.type == mpack_type_nil)
+        {
+          // Unchanged since the previous frame (version 2)
+          ok = i > 0 && c.valid[i - 1];
+          if(ok)
+          {
+            c.data[i] = c.data[i - 1];
+            c.valid[i] = true;
+          }
+          continue;
+        }
+        // Logged values are scalars or arrays of scalars
+        nodes.resize(1 + (value_tag.type == mpack_type_array ? mpack_tag_array_count(&value_tag) : 0));
+        mpack_tree_t tree;
+        mpack_tree_init_pool(&tree, value, remaining, nodes.data(), nodes.size());
+        mpack_tree_parse(&tree);
+        if(mpack_tree_error(&tree) == mpack_ok)
+        {
+          T & data = c.data[i];
+          ok = internal::DataFromNode<T>::convert(mpack_tree_root(&tree), data);
+          c.valid[i] = ok;
+        }
+        else
+        {
+          ok = false;
+        }
+        mpack_tree_destroy(&tree);
+      }
+    });
+    if(!ok)
+    {
+      log::error("Failed to decode {} from the log", e.name);
+      return;
+    }
+  }
+}
+
+bool FlatLog::decodeFrames(size_t start,
+                           size_t end,
+                           const std::unordered_map<std::string, entry *> & pending) const
+{
+  const auto & mapped = *mapped_;
+  std::vector<internal::TypedKey> keys;
+  const auto * segment = mapped.segment(start);
+  if(segment)
+  {
+    for(const auto & k : segment->keys)
+    {
+      keys.push_back({k.type, k.name});
+    }
+  }
+  // Destination of every key in the current frame, nullptr if the entry is not pending
+  std::vector<column *> columns;
+  auto update_columns = [&]() {
+    columns.clear();
+    for(const auto & k : keys)
+    {
+      column * out = nullptr;
+      auto it = pending.find(k.key);
+      if(it != pending.end())
+      {
+        for(auto & c : it->second->columns)
+        {
+          if(c->type == k.type)
+          {
+            out = c.get();
+            break;
+          }
+        }
+      }
+      columns.push_back(out);
+    }
+  };
+  update_columns();
+  for(size_t i = start; i < end; ++i)
+  {
+    bool keys_changed = false;
+    internal::LogEntry frame(mapped.version, mapped.data() + mapped.frames[i], mapped.frame_size(i), keys,
+                             keys_changed, true);
+    if(!frame.valid())
+    {
+      return false;
+    }
+    if(keys_changed)
+    {
+      update_columns();
+    }
+    auto & records = frame.records();
+    for(size_t j = 0; j < records.size(); ++j)
+    {
+      auto & r = records[j];
+      if(!columns[j] || !r.data)
+      {
+        continue;
+      }
+      internal::visit_storage(r.type, [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        auto & c = static_cast<typed_column<T> &>(*columns[j]);
+        c.data[i] = std::move(*static_cast<T *>(r.data.get()));
+        c.valid[i] = 1;
+      });
+    }
+  }
+  return true;
+}
+
+void FlatLog::decodeAll(size_t jobs)
+{
+  if(!mapped_)
+  {
+    return;
+  }
+  const auto & mapped = *mapped_;
+  // Columns are allocated beforehand so that every thread fills its own range of frames
+  std::unordered_map<std::string, entry *> pending;
+  for(auto & e : data_)
+  {
+    if(!e.decoded)
+    {
+      pending[e.name] = &e;
+    }
+  }
+  for(const auto & s : mapped.segments)
+  {
+    for(const auto & k : s.keys)
+    {
+      auto it = pending.find(k.name);
+      if(it == pending.end())
+      {
+        continue;
+      }
+      internal::visit_storage(k.type, [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        get_or_add_column<T>(*it->second).resize(size_);
+      });
+    }
+  }
+  if(jobs == 0)
+  {
+    jobs = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  jobs = std::min(jobs, std::max<size_t>(size_, 1));
+  // Split the frames in chunks, in version 2 logs a chunk must start on a keyframe
+  std::vector<size_t> bounds = {0};
+  for(size_t i = 1; i < jobs; ++i)
+  {
+    size_t bound = i * size_ / jobs;
+    if(mapped.version >= 2)
+    {
+      auto it = std::lower_bound(mapped.events.begin(), mapped.events.end(), bound);
+      bound = it == mapped.events.end() ? size_ : *it;
+    }
+    if(bound > bounds.back() && bound < size_)
+    {
+      bounds.push_back(bound);
+    }
+  }
+  bounds.push_back(size_);
+  std::vector<char> ok(bounds.size() - 1, 0);
+  std::vector<std::thread> threads;
+  for(size_t i = 1; i + 1 < bounds.size(); ++i)
+  {
+    threads.emplace_back([&, i]() { ok[i] = decodeFrames(bounds[i], bounds[i + 1], pending); });
+  }
+  ok[0] = decodeFrames(bounds[0], bounds[1], pending);
+  for(auto & th : threads)
+  {
+    th.join();
+  }
+  if(std::find(ok.begin(), ok.end(), 0) != ok.end())
+  {
+    log::error("Failed to decode some frames of the log");
+  }
+  for(auto & e : pending)
+  {
+    e.second->decoded = true;
+  }
+  mapped_.reset();
+}
+
 void FlatLog::append(const std::string & f)
 {
+  decodeAll();
   auto fpath = bfs::path(f);
   if(fpath.extension() == ".flat")
   {
@@ -46,44 +532,47 @@ void FlatLog::append(const std::string & f)
 
 void FlatLog::appendBin(const std::string & f)
 {
+  appendBin(f, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+}
+
+void FlatLog::appendBin(const std::string & f, double from, double to)
+{
+  bool ranged = std::isfinite(from) || std::isfinite(to);
   std::vector<size_t> currentIndexes = {};
-  std::vector<size_t> missingIndexes = {};
-  size_t size = data_.size() ? data_[0].records.size() : 0;
   mc_rtc::log::binary_log_callback callback = [&](const std::vector<std::string> & ks,
-                                                  std::vector<mc_rtc::log::FlatLog::record> & records, double) {
+                                                  std::vector<mc_rtc::log::FlatLog::record> & records, double t) {
+    if(ranged && t > to)
+    {
+      return false;
+    }
     if(ks.size())
     {
-      for(const auto & k : missingIndexes)
-      {
-        data_[k].records.resize(size);
-      }
       currentIndexes.clear();
       for(const auto & k : ks)
       {
-        currentIndexes.push_back(index(k, size));
-      }
-      missingIndexes.clear();
-      for(size_t i = 0; i < data_.size(); ++i)
-      {
-        if(std::find(currentIndexes.begin(), currentIndexes.end(), i) == currentIndexes.end())
-        {
-          missingIndexes.push_back(i);
-        }
+        currentIndexes.push_back(index(k));
       }
     }
     for(size_t i = 0; i < records.size(); ++i)
     {
-      auto & out = data_[currentIndexes[i]].records;
-      out.push_back(std::move(records[i]));
+      push(data_[currentIndexes[i]], size_, std::move(records[i]));
     }
-    size += 1;
+    size_ += 1;
     return true;
   };
-  iterate_binary_log(f, callback, true, "");
-  for(const auto & k : missingIndexes)
+  if(ranged)
   {
-    data_[k].records.resize(size);
+    BinaryLogReader reader(f);
+    if(reader.seek(from))
+    {
+      reader.iterate(callback, true);
+    }
+  }
+  else
+  {
+    iterate_binary_log(f, callback, true, "");
   }
+  finalize();
 }
 
 void FlatLog::appendFlat(const std::string & f)
@@ -100,11 +589,6 @@ void FlatLog::appendFlat(const std::string & f)
     log::error("Failed to open {}", f);
     return;
   }
-  size_t size = 0;
-  if(data_.size())
-  {
-    size = data_[0].records.size();
-  }
   uint64_t nEntries = 0;
   ifs.read((char *)&nEntries, sizeof(uint64_t));
   size_t nsize = 0;
@@ -116,52 +600,45 @@ void FlatLog::appendFlat(const std::string & f)
     ifs.read((char *)&sz, sizeof(uint64_t));
     std::string key(sz, '0');
     ifs.read(&key[0], static_cast<int>(sz * sizeof(char)));
-    auto idx = index(key, size);
+    auto & e = data_[index(key)];
     ifs.read((char *)&sz, sizeof(uint64_t));
-    auto & entries = data_[idx].records;
-    for(size_t i = 0; i < sz; ++i)
+    if(is_numeric)
     {
-      if(is_numeric)
+      auto & c = get_or_add_column<double>(e);
+      c.resize(size_ + sz);
+      for(size_t i = 0; i < sz; ++i)
       {
-        double data = 0;
+        double & data = c.data[size_ + i];
         ifs.read((char *)&data, sizeof(double));
-        if(std::isnan(data))
-        {
-          entries.emplace_back(LogType::None, record::unique_void_ptr{nullptr, internal::void_deleter<int>});
-        }
-        else
-        {
-          entries.emplace_back(LogType::Double,
-                               record::unique_void_ptr{new double(data), internal::void_deleter<double>});
-        }
+        c.valid[size_ + i] = !std::isnan(data);
       }
-      else
+    }
+    else
+    {
+      auto & c = get_or_add_column<std::string>(e);
+      c.resize(size_ + sz);
+      for(size_t i = 0; i < sz; ++i)
       {
         uint64_t str_sz = 0;
         ifs.read((char *)&str_sz, sizeof(uint64_t));
-        if(str_sz == 0)
+        if(str_sz != 0)
         {
-          entries.emplace_back(LogType::None, record::unique_void_ptr{nullptr, internal::void_deleter<int>});
-        }
-        else
-        {
-          std::string * str = new std::string(str_sz, '0');
-          ifs.read(&((*str)[0]), static_cast<int>(str_sz * sizeof(char)));
-          entries.emplace_back(LogType::String, record::unique_void_ptr{str, internal::void_deleter<std::string>});
+          std::string & str = c.data[size_ + i];
+          str.resize(str_sz);
+          ifs.read(&str[0], static_cast<int>(str_sz * sizeof(char)));
+          c.valid[size_ + i] = true;
         }
       }
     }
-    nsize = entries.size();
-  }
-  for(auto & e : data_)
-  {
-    e.records.resize(nsize);
+    nsize = size_ + sz;
   }
+  size_ = nsize;
+  finalize();
 }
 
 size_t FlatLog::size() const
 {
-  return data_.size() == 0 ? 0 : data_[0].records.size();
+  return size_;
 }
 
 std::set<std::string> FlatLog::entries() const
@@ -188,11 +665,13 @@ std::set<LogType> FlatLog::types(const std::string & entry) const
     return {};
   }
   std::set<LogType> ret;
-  for(const auto & r : at(entry))
+  for(const auto & c : at(entry).columns)
   {
-    ret.insert(r.type);
+    if(std::find(c->valid.begin(), c->valid.end(), true) != c->valid.end())
+    {
+      ret.insert(c->type);
+    }
   }
-  ret.erase(mc_rtc::log::LogType::None);
   return ret;
 }
 
@@ -203,14 +682,19 @@ LogType FlatLog::type(const std::string & entry) const
     log::error("No entry named {} in the loaded log", entry);
     return {};
   }
-  for(const auto & r : at(entry))
+  // Type of the column with the earliest data
+  LogType ret = mc_rtc::log::LogType::None;
+  size_t first = size_;
+  for(const auto & c : at(entry).columns)
   {
-    if(r.type != mc_rtc::log::LogType::None)
+    size_t i = static_cast<size_t>(std::distance(c->valid.begin(), std::find(c->valid.begin(), c->valid.end(), true)));
+    if(i < first)
     {
-      return r.type;
+      first = i;
+      ret = c->type;
     }
   }
-  return mc_rtc::log::LogType::None;
+  return ret;
 }
 
 LogType FlatLog::type(const std::string & entry, size_t i) const
@@ -220,42 +704,98 @@ LogType FlatLog::type(const std::string & entry, size_t i) const
     log::error("No entry named {} in the loaded log", entry);
     return LogType::None;
   }
-  const auto & records = at(entry);
-  if(i >= records.size())
+  if(i >= size_)
   {
-    log::error("Requested data ({}) out of available range ({}, available: {})", entry, i, records.size());
+    log::error("Requested data ({}) out of available range ({}, available: {})", entry, i, size_);
     return LogType::None;
   }
-  return records[i].type;
+  for(const auto & c : at(entry).columns)
+  {
+    if(c->valid[i])
+    {
+      return c->type;
+    }
+  }
+  return LogType::None;
 }
 
-const std::vector<FlatLog::record> & FlatLog::at(const std::string & entry) const
+auto FlatLog::at(const std::string & entry) const -> const FlatLog::entry &
 {
-  for(const auto & d : data_)
+  for(auto & d : data_)
   {
     if(d.name == entry)
     {
-      return d.records;
+      if(mapped_)
+      {
+        // Const accessors can be called concurrently on a lazily loaded log
+        std::lock_guard<std::mutex> lock(mapped_->decode_mutex);
+        if(!d.decoded)
+        {
+          decode(d);
+        }
+      }
+      return d;
     }
   }
   throw(std::runtime_error("No such entry"));
 }
 
-size_t FlatLog::index(const std::string & entry, size_t size)
+size_t FlatLog::index(const std::string & entry)
 {
   for(size_t i = 0; i < data_.size(); ++i)
   {
-    auto & e = data_[i];
-    if(e.name == entry)
+    if(data_[i].name == entry)
     {
-      e.records.resize(size);
       return i;
     }
   }
-  data_.push_back({entry, std::vector<FlatLog::record>{size}});
+  data_.push_back({entry, {}});
   return data_.size() - 1;
 }
 
+template<typename T>
+auto FlatLog::get_or_add_column(entry & e) -> typed_column<T> &
+{
+  for(auto & c : e.columns)
+  {
+    if(c->type == GetLogType<T>::type)
+    {
+      return static_cast<typed_column<T> &>(*c);
+    }
+  }
+  e.columns.push_back(std::make_unique<typed_column<T>>());
+  return static_cast<typed_column<T> &>(*e.columns.back());
+}
+
+void FlatLog::push(entry & e, size_t i, record && r)
+{
+  if(!r.data)
+  {
+    return;
+  }
+  internal::visit_storage(r.type, [&](auto tag) {
+    using T = typename decltype(tag)::type;
+    auto & c = get_or_add_column<T>(e);
+    if(c.data.size() <= i)
+    {
+      c.resize(i + 1);
+    }
+    c.data[i] = std::move(*static_cast<T *>(r.data.get()));
+    c.valid[i] = true;
+  });
+}
+
+void FlatLog::finalize()
+{
+  for(auto & e : data_)
+  {
+    for(auto & c : e.columns)
+    {
+      c->resize(size_);
+    }
+  }
+}
+
 } // namespace log
 
 } // namespace mc_rtc
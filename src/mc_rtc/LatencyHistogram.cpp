@@ -0,0 +1,219 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/LatencyHistogram.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mc_rtc
+{
+
+namespace
+{
+
+constexpr uint64_t maxValue = (uint64_t{1} << LatencyHistogram::maxMagnitude) - 1;
+
+/** Number of bits used to index the buckets of a power of two */
+constexpr size_t subBits = 5;
+static_assert(LatencyHistogram::subBuckets == (size_t{1} << subBits), "subBuckets must be 2^subBits");
+
+/** Index of the most significant bit of v > 0 */
+size_t msb(uint64_t v) noexcept
+{
+  size_t out = 0;
+  for(size_t shift : {32, 16, 8, 4, 2, 1})
+  {
+    if(v >> shift)
+    {
+      v >>= shift;
+      out += shift;
+    }
+  }
+  return out;
+}
+
+uint64_t toNs(double ms) noexcept
+{
+  if(!(ms > 0))
+  {
+    return 0;
+  }
+  double ns = std::round(ms * 1e6);
+  return ns >= static_cast<double>(maxValue) ? maxValue : static_cast<uint64_t>(ns);
+}
+
+double toMs(uint64_t ns) noexcept
+{
+  return static_cast<double>(ns) * 1e-6;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(double deadline, size_t window)
+: window_(new std::atomic<uint64_t>[std::max<size_t>(window, 1)]), window_size_(std::max<size_t>(window, 1))
+{
+  deadline_.store(toNs(deadline));
+  reset();
+}
+
+uint64_t LatencyHistogram::bucketValue(size_t idx) noexcept
+{
+  if(idx < subBuckets)
+  {
+    return idx;
+  }
+  size_t shift = (idx - subBuckets) / subBuckets;
+  uint64_t low = static_cast<uint64_t>(subBuckets + (idx - subBuckets) % subBuckets) << shift;
+  // Middle of the bucket
+  return low + ((uint64_t{1} << shift) >> 1);
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t ns) noexcept
+{
+  if(ns < subBuckets)
+  {
+    return static_cast<size_t>(ns);
+  }
+  size_t shift = msb(ns) - subBits;
+  return subBuckets * (shift + 1) + static_cast<size_t>((ns >> shift) - subBuckets);
+}
+
+void LatencyHistogram::record(double duration) noexcept
+{
+  uint64_t ns = toNs(duration);
+  buckets_[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+  uint64_t count = count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(ns, std::memory_order_relaxed);
+  if(ns > max_.load(std::memory_order_relaxed))
+  {
+    max_.store(ns, std::memory_order_relaxed);
+  }
+  uint64_t deadline = deadline_.load(std::memory_order_relaxed);
+  if(deadline != 0 && ns > deadline)
+  {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  window_[count % window_size_].store(ns, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const noexcept
+{
+  uint64_t count = count_.load(std::memory_order_relaxed);
+  if(count == 0)
+  {
+    return 0;
+  }
+  return toMs(sum_.load(std::memory_order_relaxed)) / static_cast<double>(count);
+}
+
+void LatencyHistogram::percentiles(const double * p, double * out, size_t n) const noexcept
+{
+  std::fill(out, out + n, 0.0);
+  uint64_t total = 0;
+  for(const auto & b : buckets_)
+  {
+    total += b.load(std::memory_order_relaxed);
+  }
+  if(total == 0)
+  {
+    return;
+  }
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  uint64_t seen = 0;
+  size_t next = 0;
+  for(size_t i = 0; i < nBuckets && next < n; ++i)
+  {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    // The percentiles are requested in increasing order
+    while(next < n
+          && static_cast<double>(seen) >= std::ceil(std::min(p[next], 100.0) / 100.0 * static_cast<double>(total)))
+    {
+      out[next++] = toMs(std::min(bucketValue(i), max));
+    }
+  }
+  for(; next < n; ++next)
+  {
+    out[next] = toMs(max);
+  }
+}
+
+double LatencyHistogram::percentile(double p) const noexcept
+{
+  double out = 0;
+  percentiles(&p, &out, 1);
+  return out;
+}
+
+double LatencyHistogram::max() const noexcept
+{
+  return toMs(max_.load(std::memory_order_relaxed));
+}
+
+double LatencyHistogram::jitter() const noexcept
+{
+  size_t n = static_cast<size_t>(std::min<uint64_t>(count_.load(std::memory_order_relaxed), window_size_));
+  if(n < 2)
+  {
+    return 0;
+  }
+  double mean = 0;
+  for(size_t i = 0; i < n; ++i)
+  {
+    mean += toMs(window_[i].load(std::memory_order_relaxed));
+  }
+  mean /= static_cast<double>(n);
+  double var = 0;
+  for(size_t i = 0; i < n; ++i)
+  {
+    double d = toMs(window_[i].load(std::memory_order_relaxed)) - mean;
+    var += d * d;
+  }
+  return std::sqrt(var / static_cast<double>(n - 1));
+}
+
+double LatencyHistogram::deadline() const noexcept
+{
+  return toMs(deadline_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::deadline(double deadline) noexcept
+{
+  deadline_.store(toNs(deadline), std::memory_order_relaxed);
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const noexcept
+{
+  Summary out;
+  out.count = count();
+  out.mean = mean();
+  const double p[3] = {50.0, 99.0, 99.9};
+  double values[3];
+  percentiles(p, values, 3);
+  out.p50 = values[0];
+  out.p99 = values[1];
+  out.p999 = values[2];
+  out.max = max();
+  out.jitter = jitter();
+  out.deadline_misses = deadlineMisses();
+  return out;
+}
+
+void LatencyHistogram::reset() noexcept
+{
+  for(auto & b : buckets_)
+  {
+    b.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  misses_.store(0, std::memory_order_relaxed);
+  for(size_t i = 0; i < window_size_; ++i)
+  {
+    window_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace mc_rtc
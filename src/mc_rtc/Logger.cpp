@@ -2,15 +2,23 @@
  * Copyright 2015-2019 CNRS-UM LIRMM, CNRS-AIST JRL
  */
 
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/Tracing.h>
+#include <mc_rtc/log/BinaryLogReader.h>
 #include <mc_rtc/log/Logger.h>
 #include <mc_rtc/utils.h>
 
+#include "internals/LogIndex.h"
+#include "internals/LogStorage.h"
+
 #include <boost/filesystem.hpp>
 namespace bfs = boost::filesystem;
 
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
+#include <mutex>
 #include <thread>
 
 namespace mc_rtc
@@ -18,22 +26,74 @@ namespace mc_rtc
 
 const uint8_t Logger::magic[4] = {0x41, 0x4e, 0x4e, 0x45};
 
-const uint8_t Logger::version = 1;
+const uint8_t Logger::version = 2;
+
+const uint64_t Logger::keyframe_period = 1000;
+
+namespace
+{
+
+/** Write the keys of a keyframe: a reset event followed by an added key event for every entry
+ *
+ * \param get Returns the type and the name of the i-th entry
+ */
+template<typename GetKey>
+void write_keys(mc_rtc::MessagePackBuilder & builder, size_t size, GetKey && get)
+{
+  builder.start_array(size + 1);
+  builder.start_array(1);
+  builder.write(static_cast<uint8_t>(2));
+  builder.finish_array();
+  for(size_t i = 0; i < size; ++i)
+  {
+    auto [type, key] = get(i);
+    builder.start_array(3);
+    builder.write(static_cast<uint8_t>(0));
+    builder.write(static_cast<typename std::underlying_type<log::LogType>::type>(type));
+    builder.write(key);
+    builder.finish_array();
+  }
+  builder.finish_array();
+}
+
+} // namespace
 
 struct LoggerImpl
 {
   LoggerImpl(const std::string & directory, const std::string & tmpl)
-  : data_(1024 * 1024), directory(directory), tmpl(tmpl)
+  : data_(1024 * 1024), builder_(data_), directory(directory), tmpl(tmpl)
   {
   }
 
   virtual ~LoggerImpl() {}
 
   virtual void initialize(const bfs::path & path) = 0;
-  virtual void write(char * data, size_t size) = 0;
+  /** Returns the buffer where the next frame should be serialized */
+  virtual std::vector<char> & buffer()
+  {
+    return data_;
+  }
+  /** Write the first \p size bytes of the buffer returned by the last call to buffer()
+   *
+   * \p keyframe and \p t are used to index the log
+   *
+   * Returns false if the frame was dropped
+   */
+  virtual bool write(size_t size, bool keyframe, double t) = 0;
   virtual void flush() {}
+  virtual Logger::Statistics statistics() const
+  {
+    return {};
+  }
+  /** True if the policy uses snapshots, see Logger::log_snapshot */
+  virtual bool snapshot() const
+  {
+    return false;
+  }
 
   std::vector<char> data_;
+  /** Builder used by Logger::log, it is reset on every frame to avoid allocating a new one */
+  mc_rtc::MessagePackBuilder builder_;
 
   bfs::path directory;
   std::string tmpl;
@@ -41,23 +101,67 @@ struct LoggerImpl
   bool valid_ = true;
   std::string path_ = "";
   std::ofstream log_;
+  /** True if the next frame must be a keyframe */
+  bool keyframe_ = true;
+  /** Number of frames written since the last keyframe */
+  uint64_t since_keyframe_ = 0;
+
+  /** Returns true if the next frame should be a keyframe given its events */
+  bool keyframe(bool has_events) const
+  {
+    return keyframe_ || has_events || since_keyframe_ + 1 >= Logger::keyframe_period;
+  }
+
+  /** Record that a frame was written */
+  void wrote(bool keyframe)
+  {
+    keyframe_ = false;
+    since_keyframe_ = keyframe ? 0 : since_keyframe_ + 1;
+  }
 
 protected:
-  inline void fwrite(char * data, uint64_t size)
+  /** Index of the file being written, keyframes are the checkpoints */
+  log::internal::LogIndex index_;
+
+  inline void fwrite(const char * data, uint64_t size, bool keyframe, double t)
   {
+    if(keyframe)
+    {
+      index_.checkpoints.push_back({index_.log_size, index_.frames, t});
+    }
     log_.write((char *)&size, sizeof(uint64_t));
     log_.write(data, static_cast<int>(size));
+    index_.log_size += sizeof(uint64_t) + size;
+    index_.frames += 1;
   }
 
   // Open file and write magic number to it right away
   void open(const std::string & path)
   {
     path_ = path;
+    keyframe_ = true;
     log_.open(path, std::ofstream::binary);
     static_assert(sizeof(uint8_t) == sizeof(char));
     log_.write((const char *)&Logger::magic, sizeof(Logger::magic) - sizeof(uint8_t));
     const char version = static_cast<uint8_t>(Logger::magic[3] + Logger::version);
     log_.write(&version, sizeof(uint8_t));
+    index_.log_size = sizeof(Logger::magic);
+    index_.frames = 0;
+    index_.checkpoints.clear();
+  }
+
+  // Close the file and write its index
+  void close()
+  {
+    if(!log_.is_open())
+    {
+      return;
+    }
+    log_.close();
+    if(!index_.save(log::BinaryLogReader::index_path(path_)))
+    {
+      mc_rtc::log::warning("Failed to write the index of {}", path_);
+    }
   }
 };
 
@@ -67,21 +171,24 @@ struct LoggerNonThreadedPolicyImpl : public LoggerImpl
 {
   LoggerNonThreadedPolicyImpl(const std::string & directory, const std::string & tmpl) : LoggerImpl(directory, tmpl) {}
 
+  ~LoggerNonThreadedPolicyImpl() override
+  {
+    close();
+  }
+
   void initialize(const bfs::path & path) final
   {
-    if(log_.is_open())
-    {
-      log_.close();
-    }
+    close();
     open(path.string());
   }
 
-  void write(char * data, size_t size) final
+  bool write(size_t size, bool keyframe, double t) final
   {
     if(valid_)
     {
-      fwrite(data, size);
+      fwrite(data_.data(), size, keyframe, t);
     }
+    return true;
   }
 
   void flush() final
@@ -93,43 +200,96 @@ struct LoggerNonThreadedPolicyImpl : public LoggerImpl
   }
 };
 
-struct LoggerThreadedPolicyImpl : public LoggerImpl
+/** Common implementation for policies where disk operations happen in a separate thread
+ *
+ * Frames are stored in a ring of pre-allocated FrameT objects:
+ * - the real-time thread takes a frame from the free queue, fills it and pushes it to the full queue;
+ * - the writer thread is woken up, writes the frame to disk and gives it back to the free queue
+ *
+ * If no frame is available the data is dropped, drops are reported by the writer thread.
+ *
+ * The real-time thread never takes writer_mutex_ so that it cannot be blocked by the writer thread. The writer can
+ * thus miss a wake-up: it finds the full queue empty, the real-time thread pushes a frame and notifies before the writer
+ * waits on the condition variable. The frame is then written when the wait times out, i.e. a missed wake-up delays the
+ * write by at most writer_timeout. This only affects the latency of the disk writes, frames are not dropped unless the
+ * ring fills up in the meantime.
+ *
+ * Derived classes must call stop() in their destructor.
+ */
+template<typename FrameT, size_t N>
+struct LoggerAsyncPolicyImpl : public LoggerImpl
 {
-  LoggerThreadedPolicyImpl(const std::string & directory, const std::string & tmpl) : LoggerImpl(directory, tmpl)
+  /** Number of frames in the ring */
+  static constexpr size_t frame_count = N;
+  /** Maximum time the writer thread sleeps if it misses a wake-up, this bounds the delay of a missed wake-up */
+  static constexpr std::chrono::milliseconds writer_timeout{10};
+
+  LoggerAsyncPolicyImpl(const std::string & directory, const std::string & tmpl)
+  : LoggerImpl(directory, tmpl), frames_(frame_count)
+  {
+    for(size_t i = 0; i < frame_count; ++i)
+    {
+      free_.push(i);
+    }
+  }
+
+  /** Write a frame to disk, called from the writer thread */
+  virtual void write_frame(FrameT & frame) = 0;
+
+  /** Start the writer thread */
+  void start()
   {
     log_sync_th_ = std::thread([this]() {
-      while(log_sync_th_run_ && valid_)
+      while(log_sync_th_run_)
       {
-        while(!write_data())
-          ;
-        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        {
+          std::unique_lock<std::mutex> lock(writer_mutex_);
+          writer_cv_.wait_for(lock, writer_timeout, [this]() { return !full_.empty() || !log_sync_th_run_; });
+        }
+        write_data();
+        report_drops();
       }
-      while(!write_data())
-        ;
+      write_data();
+      report_drops();
     });
   }
 
-  ~LoggerThreadedPolicyImpl()
+  /** Write the remaining data and stop the writer thread */
+  void stop()
   {
-    log_sync_th_run_ = false;
+    {
+      std::unique_lock<std::mutex> lock(writer_mutex_);
+      log_sync_th_run_ = false;
+    }
+    writer_cv_.notify_one();
     if(log_sync_th_.joinable())
     {
       log_sync_th_.join();
     }
   }
 
-  // Returns true when all data has been consumed
-  bool write_data()
+  // Write all the pending frames and return them to the free queue
+  void write_data()
   {
-    if(data_.pop(pop_))
+    size_t idx = 0;
+    while(full_.pop(idx))
     {
-      char * data = pop_.first;
-      size_t size = pop_.second;
-      fwrite(data, size);
-      delete[] data;
-      return false;
+      write_frame(frames_[idx]);
+      // Decremented before the frame can be acquired again so that in_flight_ never exceeds frame_count
+      in_flight_--;
+      free_.push(idx);
+    }
+  }
+
+  void report_drops()
+  {
+    uint64_t dropped = dropped_;
+    if(dropped != reported_drops_)
+    {
+      mc_rtc::log::critical("{} frame(s) could not be added to the log ({} dropped since the logger started)",
+                            dropped - reported_drops_, dropped);
+      reported_drops_ = dropped;
     }
-    return true;
   }
 
   void initialize(const bfs::path & path) final
@@ -137,30 +297,383 @@ struct LoggerThreadedPolicyImpl : public LoggerImpl
     if(log_.is_open())
     {
       /* Wait until the previous log is flushed */
-      while(!data_.empty())
+      while(in_flight_ != 0)
       {
+        writer_cv_.notify_one();
         std::this_thread::sleep_for(std::chrono::microseconds(500));
       }
-      log_.close();
+      close();
     }
     open(path.string());
   }
 
-  void write(char * data, size_t size) final
+  /** Take a frame from the free queue, returns false if none is available */
+  bool acquire(size_t & idx)
+  {
+    return free_.pop(idx);
+  }
+
+  /** Hand a frame acquired with \ref acquire to the writer thread */
+  void push(size_t idx)
   {
-    char * ndata = new char[size];
-    std::memcpy(ndata, data, size);
-    if(!data_.push({ndata, size}))
+    size_t in_flight = ++in_flight_;
+    if(in_flight > high_water_mark_)
     {
-      mc_rtc::log::critical("Data cannot be added to the log");
-      delete[] ndata;
+      high_water_mark_ = in_flight;
     }
+    // Cannot fail: there is never more than frame_count indices in the queues
+    full_.push(idx);
+    // Notified without the lock, a missed wake-up is caught by writer_timeout (see above)
+    writer_cv_.notify_one();
+  }
+
+  /** Record a dropped frame */
+  void drop()
+  {
+    dropped_++;
+  }
+
+  Logger::Statistics statistics() const final
+  {
+    return {dropped_, high_water_mark_, frame_count};
   }
 
   std::thread log_sync_th_;
-  bool log_sync_th_run_ = true;
-  CircularBuffer<std::pair<char *, size_t>, 2048> data_;
-  std::pair<char *, size_t> pop_;
+  std::atomic<bool> log_sync_th_run_{true};
+  std::mutex writer_mutex_;
+  std::condition_variable writer_cv_;
+  /** Frame storage */
+  std::vector<FrameT> frames_;
+  /** Frames available to the real-time thread */
+  CircularBuffer<size_t, frame_count> free_;
+  /** Frames waiting to be written */
+  CircularBuffer<size_t, frame_count> full_;
+  /** Number of frames waiting to be written */
+  std::atomic<size_t> in_flight_{0};
+  /** Maximum value of in_flight_ */
+  std::atomic<size_t> high_water_mark_{0};
+  /** Number of dropped frames */
+  std::atomic<uint64_t> dropped_{0};
+  /** Number of dropped frames already reported by the writer thread */
+  uint64_t reported_drops_ = 0;
+};
+
+/** A serialized frame */
+struct LogSlab
+{
+  /** Serialized data, grows to fit the largest frame seen so far */
+  std::vector<char> data;
+  /** Size of the frame */
+  size_t size = 0;
+  /** True if the frame is a keyframe */
+  bool keyframe = false;
+  /** Time of the frame */
+  double t = 0;
+};
+
+/** Threaded policy
+ *
+ * Frames are serialized directly into pre-allocated slabs that are written by the writer thread.
+ *
+ * Slabs are never released, the writer thread grows free slabs to fit the largest frame seen so far so that the
+ * real-time thread does not allocate memory once the logger has warmed up.
+ *
+ * If no slab is available the frame is serialized in a scratch buffer and dropped. Key events of a dropped frame are
+ * carried over to the next frame.
+ */
+struct LoggerThreadedPolicyImpl : public LoggerAsyncPolicyImpl<LogSlab, 512>
+{
+  /** Initial size of a slab */
+  static constexpr size_t slab_initial_size = 16 * 1024;
+
+  LoggerThreadedPolicyImpl(const std::string & directory, const std::string & tmpl)
+  : LoggerAsyncPolicyImpl(directory, tmpl)
+  {
+    for(auto & slab : frames_)
+    {
+      slab.data.resize(slab_initial_size);
+    }
+    start();
+  }
+
+  ~LoggerThreadedPolicyImpl() override
+  {
+    stop();
+    close();
+  }
+
+  void write_frame(LogSlab & slab) final
+  {
+    fwrite(slab.data.data(), slab.size, slab.keyframe, slab.t);
+    size_t slab_size = slab_size_;
+    if(slab.data.size() < slab_size)
+    {
+      slab.data.resize(slab_size);
+    }
+  }
+
+  std::vector<char> & buffer() final
+  {
+    if(acquire(current_))
+    {
+      return frames_[current_].data;
+    }
+    current_ = frame_count;
+    return data_;
+  }
+
+  bool write(size_t size, bool keyframe, double t) final
+  {
+    if(current_ == frame_count)
+    {
+      drop();
+      return false;
+    }
+    auto & slab = frames_[current_];
+    if(slab.data.size() > slab_size_)
+    {
+      slab_size_ = slab.data.size();
+    }
+    slab.size = size;
+    slab.keyframe = keyframe;
+    slab.t = t;
+    push(current_);
+    return true;
+  }
+
+  /** Slab currently used by the real-time thread (frame_count if none) */
+  size_t current_ = frame_count;
+  /** Size of the largest slab used so far */
+  std::atomic<size_t> slab_size_{slab_initial_size};
+};
+
+using log::internal::visit_storage;
+
+/** Position of every entry in a snapshot
+ *
+ * A new layout is created every time the log entries change
+ */
+struct SnapshotLayout
+{
+  SnapshotLayout(std::vector<log::LogType> types, std::vector<std::string> keys)
+  : types(std::move(types)), keys(std::move(keys))
+  {
+    offsets.reserve(this->types.size());
+    for(const auto & type : this->types)
+    {
+      visit_storage(type, [this](auto tag) {
+        using T = typename decltype(tag)::type;
+        size = (size + alignof(T) - 1) / alignof(T) * alignof(T);
+        offsets.push_back(size);
+        size += sizeof(T);
+      });
+    }
+  }
+
+  /** Type of each entry */
+  std::vector<log::LogType> types;
+  /** Name of each entry */
+  std::vector<std::string> keys;
+  /** Offset of each entry in the snapshot data */
+  std::vector<size_t> offsets;
+  /** Size of the snapshot data */
+  size_t size = 0;
+};
+
+/** Copy of every log entry at a given iteration
+ *
+ * Values are stored at fixed offsets given by the layout, values with a dynamic size (strings and vectors) keep their
+ * memory between iterations so that the copy does not allocate once warmed up
+ */
+struct LogSnapshot
+{
+  LogSnapshot() = default;
+  LogSnapshot(const LogSnapshot &) = delete;
+  LogSnapshot & operator=(const LogSnapshot &) = delete;
+
+  ~LogSnapshot()
+  {
+    clear();
+  }
+
+  /** Setup the snapshot for the given layout, this only allocates memory if the layout changed */
+  void setup(const std::shared_ptr<const SnapshotLayout> & layout)
+  {
+    if(layout == layout_)
+    {
+      return;
+    }
+    clear();
+    layout_ = layout;
+    data_.resize((layout_->size + sizeof(Chunk) - 1) / sizeof(Chunk));
+    for(size_t i = 0; i < layout_->types.size(); ++i)
+    {
+      visit_storage(layout_->types[i], [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        new(slot(i)) T(log::storage_init<T>());
+      });
+    }
+  }
+
+  /** Storage for the i-th entry */
+  void * slot(size_t i)
+  {
+    return reinterpret_cast<char *>(data_.data()) + layout_->offsets[i];
+  }
+
+  /** Storage for the i-th entry */
+  const void * slot(size_t i) const
+  {
+    return reinterpret_cast<const char *>(data_.data()) + layout_->offsets[i];
+  }
+
+  const SnapshotLayout & layout() const
+  {
+    return *layout_;
+  }
+
+  /** True if both snapshots share the same layout */
+  bool same_layout(const LogSnapshot & other) const
+  {
+    return layout_ && layout_ == other.layout_;
+  }
+
+  /** Exchange the data of two snapshots, events are not exchanged */
+  void swap(LogSnapshot & other)
+  {
+    std::swap(layout_, other.layout_);
+    std::swap(data_, other.data_);
+  }
+
+  /** Copy the data of another snapshot, events are not copied */
+  void copy(const LogSnapshot & other)
+  {
+    setup(other.layout_);
+    for(size_t i = 0; i < layout_->types.size(); ++i)
+    {
+      visit_storage(layout_->types[i], [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        *static_cast<T *>(slot(i)) = *static_cast<const T *>(other.slot(i));
+      });
+    }
+  }
+
+  /** Events that happened before this snapshot */
+  std::vector<Logger::LogEvent> events;
+  /** Time of the snapshot */
+  double t = 0;
+
+private:
+  /** Memory unit for the snapshot data, aligned for every stored type */
+  struct alignas(64) Chunk
+  {
+    char data[64];
+  };
+
+  std::shared_ptr<const SnapshotLayout> layout_;
+  std::vector<Chunk> data_;
+
+  void clear()
+  {
+    if(!layout_)
+    {
+      return;
+    }
+    for(size_t i = 0; i < layout_->types.size(); ++i)
+    {
+      visit_storage(layout_->types[i], [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        static_cast<T *>(slot(i))->~T();
+      });
+    }
+    layout_.reset();
+  }
+};
+
+/** Snapshot policy
+ *
+ * The real-time thread only copies the log entries into a snapshot, the writer thread serializes the snapshot and
+ * writes it to disk.
+ */
+struct LoggerSnapshotPolicyImpl : public LoggerAsyncPolicyImpl<LogSnapshot, 64>
+{
+  LoggerSnapshotPolicyImpl(const std::string & directory, const std::string & tmpl)
+  : LoggerAsyncPolicyImpl(directory, tmpl)
+  {
+    start();
+  }
+
+  ~LoggerSnapshotPolicyImpl() override
+  {
+    stop();
+    close();
+  }
+
+  bool write(size_t, bool, double) final
+  {
+    mc_rtc::log::error_and_throw("Serialized data cannot be written with the snapshot policy");
+  }
+
+  void write_frame(LogSnapshot & snapshot) final
+  {
+    bool keyframe = this->keyframe(snapshot.events.size()) || !snapshot.same_layout(previous_);
+    mc_rtc::MessagePackBuilder builder(data_);
+    const auto & layout = snapshot.layout();
+    builder.start_array(2);
+    if(keyframe)
+    {
+      write_keys(builder, layout.types.size(),
+                 [&](size_t i) { return std::make_pair(layout.types[i], std::cref(layout.keys[i])); });
+    }
+    else
+    {
+      builder.write();
+    }
+    builder.start_array(layout.types.size());
+    for(size_t i = 0; i < layout.types.size(); ++i)
+    {
+      visit_storage(layout.types[i], [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        const auto & value = *static_cast<const T *>(snapshot.slot(i));
+        if(!keyframe && log::storage_equal(value, *static_cast<const T *>(previous_.slot(i))))
+        {
+          builder.write();
+        }
+        else
+        {
+          builder.write(value);
+        }
+      });
+    }
+    builder.finish_array();
+    builder.finish_array();
+    size_t s = builder.finish();
+    fwrite(data_.data(), s, keyframe, snapshot.t);
+    wrote(keyframe);
+    snapshot.events.clear();
+    // The written values become the reference for the next frame
+    if(snapshot.same_layout(previous_))
+    {
+      previous_.swap(snapshot);
+    }
+    else
+    {
+      // Keep the snapshot memory as-is so that the real-time thread does not allocate when it re-uses it
+      previous_.copy(snapshot);
+    }
+  }
+
+  bool snapshot() const final
+  {
+    return true;
+  }
+
+  /** Current layout of the entries */
+  std::shared_ptr<const SnapshotLayout> layout_;
+  /** Used when no snapshot is available */
+  LogSnapshot scratch_;
+  /** Last snapshot written by the writer thread */
+  LogSnapshot previous_;
 };
 } // namespace
 
@@ -181,6 +694,9 @@ void Logger::setup(const Policy & policy, const std::string & directory, const s
     case Policy::THREADED:
       impl_.reset(new LoggerThreadedPolicyImpl(directory, tmpl));
       break;
+    case Policy::SNAPSHOT:
+      impl_.reset(new LoggerSnapshotPolicyImpl(directory, tmpl));
+      break;
   };
 }
 
@@ -287,40 +803,22 @@ void Logger::open(const std::string & file, double timestep, double start_t)
 
 void Logger::log()
 {
-  mc_rtc::MessagePackBuilder builder(impl_->data_);
+  MC_RTC_TRACE_SPAN("Logger::log");
+  mc_rtc::alloc::Scope alloc_scope("Logger::log");
+  if(impl_->snapshot())
+  {
+    log_snapshot();
+    return;
+  }
+  bool keyframe = impl_->keyframe(log_events_.size());
+  double t = impl_->log_iter_;
+  auto & builder = impl_->builder_;
+  builder.reset(impl_->buffer());
   builder.start_array(2);
-  if(log_events_.size())
+  if(keyframe)
   {
-    builder.start_array(log_events_.size());
-    auto event_visitor = [&builder](auto && event) {
-      using T = std::decay_t<decltype(event)>;
-      if constexpr(std::is_same_v<T, KeyAddedEvent>)
-      {
-        builder.start_array(3);
-        builder.write(static_cast<uint8_t>(0));
-        builder.write(static_cast<typename std::underlying_type<log::LogType>::type>(event.type));
-        builder.write(event.key);
-        builder.finish_array();
-      }
-      else if constexpr(std::is_same_v<T, KeyRemovedEvent>)
-      {
-        builder.start_array(2);
-        builder.write(static_cast<uint8_t>(1));
-        builder.write(event.key);
-        builder.finish_array();
-      }
-      else
-      {
-        static_assert(!std::is_same_v<T, T>, "non-exhaustive visitor");
-      }
-    };
-
-    for(auto & e : log_events_)
-    {
-      std::visit(event_visitor, e);
-    }
-    builder.finish_array();
-    log_events_.resize(0);
+    write_keys(builder, log_entries_.size(),
+               [this](size_t i) { return std::make_pair(log_entries_[i].type, std::cref(log_entries_[i].key)); });
   }
   else
   {
@@ -329,12 +827,59 @@ void Logger::log()
   builder.start_array(log_entries_.size());
   for(auto & e : log_entries_)
   {
-    e.log_cb(builder);
+    e.log_cb(builder, keyframe);
   }
   builder.finish_array();
   builder.finish_array();
   size_t s = builder.finish();
-  impl_->write(impl_->data_.data(), s);
+  // Events are kept for the next frame if this one was dropped and the next frame must be a keyframe
+  if(impl_->write(s, keyframe, t))
+  {
+    impl_->wrote(keyframe);
+    log_events_.resize(0);
+  }
+  else
+  {
+    impl_->keyframe_ = true;
+  }
+}
+
+void Logger::log_snapshot()
+{
+  auto & impl = static_cast<LoggerSnapshotPolicyImpl &>(*impl_);
+  if(log_events_.size() || !impl.layout_)
+  {
+    std::vector<log::LogType> types;
+    std::vector<std::string> keys;
+    types.reserve(log_entries_.size());
+    keys.reserve(log_entries_.size());
+    for(const auto & e : log_entries_)
+    {
+      types.push_back(e.type);
+      keys.push_back(e.key);
+    }
+    impl.layout_ = std::make_shared<const SnapshotLayout>(std::move(types), std::move(keys));
+  }
+  size_t idx = 0;
+  bool acquired = impl.acquire(idx);
+  auto & snapshot = acquired ? impl.frames_[idx] : impl.scratch_;
+  snapshot.setup(impl.layout_);
+  snapshot.t = impl.log_iter_;
+  for(size_t i = 0; i < log_entries_.size(); ++i)
+  {
+    log_entries_[i].snapshot_cb(snapshot.slot(i));
+  }
+  if(acquired)
+  {
+    // The writer thread clears the events it wrote so this gives back an empty vector
+    std::swap(snapshot.events, log_events_);
+    impl.push(idx);
+  }
+  else
+  {
+    // Events are kept for the next frame
+    impl.drop();
+  }
 }
 
 void Logger::removeLogEntry(const std::string & name)
@@ -378,4 +923,9 @@ void Logger::flush()
   impl_->flush();
 }
 
+Logger::Statistics Logger::statistics() const
+{
+  return impl_->statistics();
+}
+
 } // namespace mc_rtc
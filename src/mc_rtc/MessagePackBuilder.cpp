@@ -85,6 +85,11 @@ static void mpack_std_vector_writer_flush(mpack_writer_t * writer, const char *
 }
 
 MessagePackBuilder::MessagePackBuilder(std::vector<char> & buffer) : impl_(new MessagePackBuilderImpl())
+{
+  reset(buffer);
+}
+
+void MessagePackBuilder::reset(std::vector<char> & buffer)
 {
   if(buffer.size() == 0)
   {
@@ -300,6 +305,11 @@ void MessagePackBuilder::write_object(const char * data, size_t s)
   mpack_write_object_bytes(impl_.get(), data, s);
 }
 
+size_t MessagePackBuilder::size() const
+{
+  return mpack_writer_buffer_used(impl_.get());
+}
+
 size_t MessagePackBuilder::finish()
 {
   if(mpack_writer_destroy(impl_.get()) != mpack_ok)
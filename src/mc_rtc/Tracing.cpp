@@ -0,0 +1,244 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/Tracing.h>
+
+#include <mc_rtc/clock.h>
+#include <mc_rtc/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mc_rtc
+{
+
+namespace trace
+{
+
+namespace
+{
+
+/** Ring buffer of the events recorded by a thread */
+struct ThreadBuffer
+{
+  ThreadBuffer(size_t size, size_t tid) : events(new Event[size]), size(size), tid(tid) {}
+
+  std::unique_ptr<Event[]> events;
+  size_t size;
+  /** Index of the next event */
+  std::atomic<uint64_t> head{0};
+  size_t tid;
+  /** Protected by the registry mutex */
+  std::string name;
+};
+
+/** Number of tick timestamps that are kept */
+constexpr size_t maxTicks = 4096;
+
+struct Registry
+{
+  std::atomic<bool> enabled{true};
+  std::atomic<size_t> buffer_size{16384};
+  std::mutex mutex;
+  /** Buffers are kept after their thread exits so that their events can still be dumped */
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::array<std::atomic<uint64_t>, maxTicks> ticks;
+  std::atomic<uint64_t> nticks{0};
+};
+
+Registry & registry()
+{
+  static Registry registry;
+  return registry;
+}
+
+ThreadBuffer & threadBuffer()
+{
+  static thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+    auto & reg = registry();
+    std::unique_lock<std::mutex> lock(reg.mutex);
+    reg.buffers.push_back(std::make_shared<ThreadBuffer>(std::max<size_t>(reg.buffer_size, 1), reg.buffers.size()));
+    return reg.buffers.back();
+  }();
+  return *buffer;
+}
+
+/** Write \p in as a JSON string */
+void writeString(std::ostream & os, const char * in)
+{
+  os << '"';
+  for(; *in; ++in)
+  {
+    char c = *in;
+    if(c == '"' || c == '\\')
+    {
+      os << '\\' << c;
+    }
+    else if(static_cast<unsigned char>(c) < 0x20)
+    {
+      os << fmt::format("\\u{:04x}", static_cast<int>(c));
+    }
+    else
+    {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+} // namespace
+
+uint64_t now() noexcept
+{
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(mc_rtc::clock::now().time_since_epoch()).count());
+}
+
+bool enabled() noexcept
+{
+  return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void enable(bool enabled) noexcept
+{
+  registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void bufferSize(size_t size)
+{
+  registry().buffer_size = size;
+}
+
+void threadName(const std::string & name)
+{
+  auto & buffer = threadBuffer();
+  std::unique_lock<std::mutex> lock(registry().mutex);
+  buffer.name = name;
+}
+
+void record(const Event & event) noexcept
+{
+  auto & buffer = threadBuffer();
+  uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  buffer.events[head % buffer.size] = event;
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void tick() noexcept
+{
+  auto & reg = registry();
+  uint64_t n = reg.nticks.load(std::memory_order_relaxed);
+  reg.ticks[n % maxTicks].store(now(), std::memory_order_relaxed);
+  reg.nticks.store(n + 1, std::memory_order_release);
+}
+
+void Span::start(const char * category, const char * name) noexcept
+{
+  event_.category = category;
+  std::strncpy(event_.name, name, sizeof(event_.name) - 1);
+  event_.name[sizeof(event_.name) - 1] = 0;
+  event_.start = now();
+}
+
+bool dump(const std::string & path, size_t ticks)
+{
+  auto & reg = registry();
+  uint64_t since = 0;
+  uint64_t nticks = reg.nticks.load(std::memory_order_acquire);
+  if(ticks != 0 && nticks != 0)
+  {
+    uint64_t n = std::min<uint64_t>({ticks, nticks, maxTicks});
+    since = reg.ticks[(nticks - n) % maxTicks].load(std::memory_order_relaxed);
+  }
+  struct ThreadEvents
+  {
+    size_t tid;
+    std::string name;
+    std::vector<Event> events;
+  };
+  std::vector<ThreadEvents> threads;
+  {
+    std::unique_lock<std::mutex> lock(reg.mutex);
+    for(const auto & buffer : reg.buffers)
+    {
+      threads.push_back({buffer->tid, buffer->name, {}});
+      auto & events = threads.back().events;
+      uint64_t head = buffer->head.load(std::memory_order_acquire);
+      uint64_t first = head > buffer->size ? head - buffer->size : 0;
+      events.reserve(static_cast<size_t>(head - first));
+      for(uint64_t i = first; i < head; ++i)
+      {
+        events.push_back(buffer->events[i % buffer->size]);
+      }
+      // Discard the events that were overwritten while they were copied
+      uint64_t new_head = buffer->head.load(std::memory_order_acquire);
+      // The event new_head might be being written
+      if(new_head + 1 > first + buffer->size)
+      {
+        size_t overwritten =
+            static_cast<size_t>(std::min<uint64_t>(new_head + 1 - first - buffer->size, events.size()));
+        events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+      }
+    }
+  }
+  uint64_t origin = std::numeric_limits<uint64_t>::max();
+  for(auto & t : threads)
+  {
+    t.events.erase(std::remove_if(t.events.begin(), t.events.end(), [&](const Event & e) { return e.start < since; }),
+                   t.events.end());
+    for(const auto & e : t.events)
+    {
+      origin = std::min(origin, e.start);
+    }
+  }
+  std::ofstream os(path);
+  if(!os.is_open())
+  {
+    log::error("[mc_rtc::trace] Failed to open {} to dump the trace", path);
+    return false;
+  }
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&]() {
+    if(!first)
+    {
+      os << ",\n";
+    }
+    first = false;
+  };
+  for(const auto & t : threads)
+  {
+    if(t.name.size())
+    {
+      separator();
+      os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << t.tid << ",\"args\":{\"name\":";
+      writeString(os, t.name.c_str());
+      os << "}}";
+    }
+    for(const auto & e : t.events)
+    {
+      separator();
+      os << "{\"name\":";
+      writeString(os, e.name);
+      os << ",\"cat\":";
+      writeString(os, e.category);
+      os << fmt::format(",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", t.tid,
+                        static_cast<double>(e.start - origin) * 1e-3,
+                        static_cast<double>(e.end - e.start) * 1e-3);
+    }
+  }
+  os << "]}\n";
+  return static_cast<bool>(os);
+}
+
+} // namespace trace
+
+} // namespace mc_rtc
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/WorkerPool.h>
+
+#include <mc_rtc/clock.h>
+#include <mc_rtc/logging.h>
+
+#ifdef __linux__
+#  include <pthread.h>
+#endif
+
+namespace mc_rtc
+{
+
+namespace
+{
+
+/** Hint the CPU that we are spinning */
+inline void cpu_relax() noexcept
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+} // namespace
+
+WorkerPool::WorkerPool(size_t threads, const std::vector<int> & cpus, std::chrono::microseconds spin) : spin_(spin)
+{
+  threads_.reserve(threads);
+  for(size_t i = 0; i < threads; ++i)
+  {
+    threads_.emplace_back([this]() {
+      uint64_t generation = 0;
+      while(wait_job(generation))
+      {
+        process();
+        // The sequentially consistent operations on active_ and waiting_ ensure that either the last worker sees that
+        // run is sleeping or run sees that every worker is done before it sleeps
+        if(active_.fetch_sub(1) == 1 && waiting_.load())
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          done_cv_.notify_one();
+        }
+      }
+    });
+    if(cpus.empty())
+    {
+      continue;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[i % cpus.size()], &set);
+    if(pthread_setaffinity_np(threads_.back().native_handle(), sizeof(cpu_set_t), &set) != 0)
+    {
+      log::warning("[WorkerPool] Failed to pin worker {} to CPU {}", i, cpus[i % cpus.size()]);
+    }
+#else
+    log::warning("[WorkerPool] Pinning worker threads is not supported on this platform");
+#endif
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+    cv_.notify_all();
+  }
+  for(auto & th : threads_)
+  {
+    th.join();
+  }
+}
+
+void WorkerPool::run_impl(size_t n, job_t job, const void * data)
+{
+  if(threads_.empty() || n < 2)
+  {
+    for(size_t i = 0; i < n; ++i)
+    {
+      job(data, i);
+    }
+    return;
+  }
+  job_ = job;
+  data_ = data;
+  n_ = n;
+  next_.store(0, std::memory_order_relaxed);
+  active_.store(threads_.size(), std::memory_order_relaxed);
+  // Publishes the job, the sequentially consistent operations on generation_ and sleeping_ ensure that either a
+  // worker going to sleep sees the new generation or we see that it sleeps
+  generation_.fetch_add(1);
+  if(sleeping_.load() != 0)
+  {
+    // A worker holds the mutex until it waits on cv_ so it cannot miss this notification
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.notify_all();
+  }
+  process();
+  wait_done();
+}
+
+bool WorkerPool::wait_job(uint64_t & generation)
+{
+  auto start_t = clock::now();
+  while(generation_.load() == generation && !stop_.load())
+  {
+    if(clock::now() - start_t > spin_)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleeping_++;
+      cv_.wait(lock, [&]() { return stop_.load() || generation_.load() != generation; });
+      sleeping_--;
+      break;
+    }
+    cpu_relax();
+  }
+  if(stop_.load())
+  {
+    return false;
+  }
+  generation = generation_.load();
+  return true;
+}
+
+void WorkerPool::wait_done()
+{
+  auto start_t = clock::now();
+  while(active_.load() != 0)
+  {
+    if(clock::now() - start_t > spin_)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      waiting_ = true;
+      done_cv_.wait(lock, [this]() { return active_.load() == 0; });
+      waiting_ = false;
+      return;
+    }
+    cpu_relax();
+  }
+}
+
+void WorkerPool::process()
+{
+  size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+  while(i < n_)
+  {
+    job_(data_, i);
+    i = next_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace mc_rtc
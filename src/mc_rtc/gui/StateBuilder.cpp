@@ -6,6 +6,10 @@
 
 #include <mc_rtc/gui/plot/types.h>
 
+#include <mc_rtc/Tracing.h>
+
+#include <cstring>
+
 namespace mc_rtc
 {
 
@@ -15,6 +19,7 @@ namespace gui
 // Repeat static constexpr declarations
 // See https://stackoverflow.com/q/8016780
 constexpr int8_t StateBuilder::PROTOCOL_VERSION;
+constexpr int8_t StateBuilder::DELTA_PROTOCOL_VERSION;
 
 const Color Color::White = Color(1, 1, 1, 1);
 const Color Color::Black = Color(0, 0, 0, 1);
@@ -50,6 +55,7 @@ void StateBuilder::reset()
 {
   elements_.elements.clear();
   elements_.sub.clear();
+  tree_changed_ = true;
 }
 
 std::string StateBuilder::cat2str(const std::vector<std::string> & cat)
@@ -83,6 +89,7 @@ void StateBuilder::removeCategory(const std::vector<std::string> & category)
     mc_rtc::log::warning("Call clear() if this was your intent");
     return;
   }
+  tree_changed_ = true;
   size_t depth = category.size() - 1;
   auto cat = getCategory(category, depth);
   while(cat)
@@ -131,6 +138,7 @@ void StateBuilder::removeElement(const std::vector<std::string> & category, cons
   if(it != cat.elements.end())
   {
     cat.elements.erase(it);
+    tree_changed_ = true;
   }
   if(cat.elements.size() == 0 && cat.sub.size() == 0)
   {
@@ -149,6 +157,7 @@ void StateBuilder::removeElements(const std::vector<std::string> & category, voi
   {
     return;
   }
+  tree_changed_ = true;
   auto & elements = cat_->elements;
   if(recurse)
   {
@@ -172,6 +181,7 @@ void StateBuilder::removeElements(void * source)
   {
     return;
   }
+  tree_changed_ = true;
   removeElements(elements_, source);
 }
 
@@ -192,6 +202,7 @@ void StateBuilder::removeElements(Category & category, void * source)
 
 size_t StateBuilder::update(std::vector<char> & buffer)
 {
+  MC_RTC_TRACE_SPAN("StateBuilder::update");
   mc_rtc::MessagePackBuilder builder(buffer);
   builder.start_array(4);
 
@@ -210,6 +221,170 @@ size_t StateBuilder::update(std::vector<char> & buffer)
   update(builder, elements_);
 
   // Write plots
+  updatePlots(builder);
+
+  builder.finish_array();
+  return builder.finish();
+}
+
+size_t StateBuilder::updateDelta(std::vector<char> & buffer, bool full)
+{
+  capture(delta_snapshot_);
+  return delta_encoder_.updateDelta(delta_snapshot_, buffer, full);
+}
+
+void StateBuilder::capture(Snapshot & snapshot)
+{
+  MC_RTC_TRACE_SPAN("StateBuilder::capture");
+  if(update_data_)
+  {
+    data_buffer_size_ = data_.toMessagePack(data_buffer_);
+    update_data_ = false;
+  }
+  if(snapshot.data.size() < data_buffer_size_)
+  {
+    snapshot.data.resize(data_buffer_size_);
+  }
+  std::memcpy(snapshot.data.data(), data_buffer_.data(), data_buffer_size_);
+  snapshot.data_size = data_buffer_size_;
+
+  snapshot.offsets.clear();
+  {
+    mc_rtc::MessagePackBuilder builder(snapshot.elements);
+    builder.start_array(elements_.size());
+    size_t idx = 0;
+    capture(builder, elements_, snapshot, idx);
+    snapshot.categories.resize(idx);
+    snapshot.offsets.push_back(builder.size());
+    builder.finish_array();
+    builder.finish();
+  }
+
+  {
+    mc_rtc::MessagePackBuilder builder(snapshot.plots);
+    updatePlots(builder);
+    snapshot.plots_size = builder.finish();
+  }
+
+  snapshot.reset = tree_changed_;
+  tree_changed_ = false;
+}
+
+void StateBuilder::capture(mc_rtc::MessagePackBuilder & builder, Category & category, Snapshot & snapshot, size_t & idx)
+{
+  if(idx == snapshot.categories.size())
+  {
+    snapshot.categories.emplace_back();
+  }
+  auto & layout = snapshot.categories[idx++];
+  layout.name = category.name;
+  layout.elements = category.elements.size();
+  layout.sub = category.sub.size();
+  for(auto & e : category.elements)
+  {
+    snapshot.offsets.push_back(builder.size());
+    e.write(e.element(), builder);
+  }
+  for(auto & s : category.sub)
+  {
+    capture(builder, s, snapshot, idx);
+  }
+}
+
+size_t StateBuilder::Encoder::update(const Snapshot & snapshot, std::vector<char> & buffer) const
+{
+  MC_RTC_TRACE_SPAN("StateBuilder::Encoder::update");
+  mc_rtc::MessagePackBuilder builder(buffer);
+  write(builder, snapshot, 4, PROTOCOL_VERSION);
+  builder.finish_array();
+  return builder.finish();
+}
+
+size_t StateBuilder::Encoder::updateDelta(const Snapshot & snapshot, std::vector<char> & buffer, bool full)
+{
+  MC_RTC_TRACE_SPAN("StateBuilder::Encoder::updateDelta");
+  mc_rtc::MessagePackBuilder builder(buffer);
+  if(full || snapshot.reset || id_ == 0 || snapshot.offsets.size() != offsets_.size()
+     || snapshot.data_size != data_.size() || std::memcmp(snapshot.data.data(), data_.data(), data_.size()) != 0)
+  {
+    id_++;
+    write(builder, snapshot, 5, DELTA_PROTOCOL_VERSION);
+    builder.write(id_);
+    builder.finish_array();
+    data_.assign(snapshot.data.begin(), snapshot.data.begin() + static_cast<std::ptrdiff_t>(snapshot.data_size));
+    elements_.assign(snapshot.elements.begin(),
+                     snapshot.elements.begin() + static_cast<std::ptrdiff_t>(snapshot.offsets.back()));
+    offsets_ = snapshot.offsets;
+    return builder.finish();
+  }
+
+  changed_.clear();
+  for(size_t i = 0; i + 1 < snapshot.offsets.size(); ++i)
+  {
+    size_t size = snapshot.offsets[i + 1] - snapshot.offsets[i];
+    if(size != offsets_[i + 1] - offsets_[i]
+       || std::memcmp(snapshot.elements.data() + snapshot.offsets[i], elements_.data() + offsets_[i], size) != 0)
+    {
+      changed_.push_back(i);
+    }
+  }
+  builder.start_array(6);
+  builder.write(DELTA_PROTOCOL_VERSION);
+  builder.write();
+  builder.write();
+  builder.write_object(snapshot.plots.data(), snapshot.plots_size);
+  builder.write(id_);
+  builder.start_array(changed_.size());
+  for(auto i : changed_)
+  {
+    builder.start_array(2);
+    builder.write(static_cast<uint64_t>(i));
+    builder.write_object(snapshot.elements.data() + snapshot.offsets[i], snapshot.offsets[i + 1] - snapshot.offsets[i]);
+    builder.finish_array();
+  }
+  builder.finish_array();
+  builder.finish_array();
+  return builder.finish();
+}
+
+void StateBuilder::Encoder::write(mc_rtc::MessagePackBuilder & builder,
+                                  const Snapshot & snapshot,
+                                  size_t size,
+                                  int8_t version)
+{
+  builder.start_array(size);
+  builder.write(version);
+  builder.write_object(snapshot.data.data(), snapshot.data_size);
+  size_t category = 0;
+  size_t idx = 0;
+  writeCategory(builder, snapshot, category, idx);
+  builder.write_object(snapshot.plots.data(), snapshot.plots_size);
+}
+
+void StateBuilder::Encoder::writeCategory(mc_rtc::MessagePackBuilder & builder,
+                                          const Snapshot & snapshot,
+                                          size_t & category,
+                                          size_t & idx)
+{
+  const auto & layout = snapshot.categories[category++];
+  builder.start_array(1 + layout.elements + 1);
+  builder.write(layout.name);
+  for(size_t i = 0; i < layout.elements; ++i, ++idx)
+  {
+    builder.write_object(snapshot.elements.data() + snapshot.offsets[idx],
+                         snapshot.offsets[idx + 1] - snapshot.offsets[idx]);
+  }
+  builder.start_array(layout.sub);
+  for(size_t i = 0; i < layout.sub; ++i)
+  {
+    writeCategory(builder, snapshot, category, idx);
+  }
+  builder.finish_array();
+  builder.finish_array();
+}
+
+void StateBuilder::updatePlots(mc_rtc::MessagePackBuilder & builder)
+{
   builder.start_array(plots_.size());
   for(auto & p : plots_)
   {
@@ -218,9 +393,6 @@ size_t StateBuilder::update(std::vector<char> & buffer)
     builder.finish_array();
   }
   builder.finish_array();
-
-  builder.finish_array();
-  return builder.finish();
 }
 
 void StateBuilder::update()
@@ -5,6 +5,7 @@
 
 #include <optional>
 
+#include "LogStorage.h"
 #include "mpack.h"
 
 namespace mc_rtc
@@ -366,23 +367,55 @@ inline FlatLog::record recordFromNode(LogType type, mpack_node_t node, bool extr
   }
 }
 
+// Since version 2, update the last known value of an entry from a (non-nil) node
+inline bool updateFromNode(LogType type, FlatLog::record & last, mpack_node_t node)
+{
+  bool ok = false;
+  visit_storage(type, [&](auto tag) {
+    using T = typename decltype(tag)::type;
+    if(!last.data || last.type != type)
+    {
+      last.type = type;
+      last.data = {new T{}, void_deleter<T>};
+    }
+    ok = DataFromNode<T>::convert(node, *static_cast<T *>(last.data.get()));
+  });
+  return ok;
+}
+
+// Copy the data held by a record
+inline FlatLog::record cloneRecord(const FlatLog::record & r)
+{
+  FlatLog::record out{r.type, {nullptr, void_deleter<int>}};
+  if(r.data)
+  {
+    visit_storage(r.type, [&](auto tag) {
+      using T = typename decltype(tag)::type;
+      out.data = {new T(*static_cast<const T *>(r.data.get())), void_deleter<T>};
+    });
+  }
+  return out;
+}
+
 struct TypedKey
 {
   LogType type;
   std::string key;
+  /** Since version 2, last value stored for this key (unchanged values are stored as nil) */
+  FlatLog::record last = {LogType::None, {nullptr, void_deleter<int>}};
 };
 
 struct LogEntry : mpack_tree_t
 {
   LogEntry(int8_t version,
-           const std::vector<char> & data,
+           const char * data,
            size_t size,
            std::vector<TypedKey> & keysOut,
            bool & keysChanged,
            bool extract_data = true)
-  : version_(version)
+  : version_(version), keys_out_(&keysOut)
   {
-    mpack_tree_init_data(this, data.data(), size);
+    mpack_tree_init_data(this, data, size);
     mpack_tree_parse(this);
     if(mpack_tree_error(this) != mpack_ok)
     {
@@ -453,7 +486,7 @@ struct LogEntry : mpack_tree_t
         }
       }
     }
-    else if(version_ == 1)
+    else if(version_ == 1 || version_ == 2)
     {
       auto events = mpack_node_array_at(root_, 0);
       if(mpack_node_type(events) == mpack_type_nil)
@@ -512,6 +545,12 @@ struct LogEntry : mpack_tree_t
             }
             keysOut.push_back({type, std::string(*key)});
           }
+          else if(event_t == 2 && version_ == 2)
+          {
+            // Reset event, the full key table follows
+            keysOut.clear();
+            checkpoint_ = true;
+          }
           else if(event_t == 1)
           {
             // Remove key event
@@ -555,9 +594,50 @@ struct LogEntry : mpack_tree_t
         return;
       }
       size_t s = mpack_node_array_length(records);
-      for(size_t i = 0; i < s; ++i)
+      if(s != keysOut.size())
       {
-        records_.push_back(recordFromNode(keysOut[i].type, records, extract_data, i));
+        log::error("MessagePack stored records do not match the keys ({} records for {} keys)", s, keysOut.size());
+        valid_ = false;
+        return;
+      }
+      if(version_ == 1)
+      {
+        for(size_t i = 0; i < s; ++i)
+        {
+          records_.push_back(recordFromNode(keysOut[i].type, records, extract_data, i));
+        }
+      }
+      else
+      {
+        // Values are always decoded since the next entries might refer to them
+        for(size_t i = 0; i < s; ++i)
+        {
+          auto & k = keysOut[i];
+          auto value = mpack_node_array_at(records, i);
+          if(mpack_node_type(value) != mpack_type_nil)
+          {
+            if(!updateFromNode(k.type, k.last, value))
+            {
+              log::error("Failed to read {} from MessagePack data", k.key);
+              valid_ = false;
+              return;
+            }
+          }
+          else if(!k.last.data)
+          {
+            log::error("No previous value for {} in the log", k.key);
+            valid_ = false;
+            return;
+          }
+          if(extract_data)
+          {
+            records_.push_back(cloneRecord(k.last));
+          }
+          else
+          {
+            records_.push_back({k.type, {nullptr, void_deleter<int>}});
+          }
+        }
       }
     }
     else
@@ -588,6 +668,39 @@ struct LogEntry : mpack_tree_t
     return records_;
   }
 
+  /** True if this entry holds the full key table (since version 2) */
+  bool checkpoint() const
+  {
+    return checkpoint_;
+  }
+
+  /** Extract the data of the records if this entry was created without extracting data */
+  void extract()
+  {
+    assert(valid_);
+    auto records = mpack_node_array_at(root_, 1);
+    for(size_t i = 0; i < records_.size(); ++i)
+    {
+      auto & r = records_[i];
+      if(r.data)
+      {
+        continue;
+      }
+      if(version_ == 0)
+      {
+        r = recordFromNode(records, true, 2 * i);
+      }
+      else if(version_ == 1)
+      {
+        r = recordFromNode(r.type, records, true, i);
+      }
+      else
+      {
+        r = cloneRecord((*keys_out_)[i].last);
+      }
+    }
+  }
+
   /** Should only be used to retrieve time values from the log */
   double getTime(size_t idx)
   {
@@ -597,6 +710,10 @@ struct LogEntry : mpack_tree_t
     {
       return mpack_node_double(mpack_node_array_at(values, 2 * idx + 1));
     }
+    else if(version_ == 2)
+    {
+      return *static_cast<const double *>((*keys_out_)[idx].last.data.get());
+    }
     else
     {
       return mpack_node_double(mpack_node_array_at(values, idx));
@@ -611,7 +728,18 @@ struct LogEntry : mpack_tree_t
     {
       mc_rtc::log::error_and_throw("Expected to copy {} but has {} records", keys.size(), records_.size());
     }
-    builder.start_array(keys.size());
+    if(version_ == 2)
+    {
+      // Reset event so that the copy is a checkpoint
+      builder.start_array(keys.size() + 1);
+      builder.start_array(1);
+      builder.write(static_cast<uint8_t>(2));
+      builder.finish_array();
+    }
+    else
+    {
+      builder.start_array(keys.size());
+    }
     for(size_t i = 0; i < keys.size(); ++i)
     {
       const auto & k = keys[i];
@@ -623,13 +751,32 @@ struct LogEntry : mpack_tree_t
       builder.finish_array();
     }
     builder.finish_array();
-    copy(builder, mpack_node_array_at(root_, 1));
+    if(version_ == 2)
+    {
+      // Unchanged values are not in the node, write the values stored in the keys instead
+      builder.start_array(keys.size());
+      for(size_t i = 0; i < keys.size(); ++i)
+      {
+        const auto & last = (*keys_out_)[i].last;
+        visit_storage(last.type, [&](auto tag) {
+          using T = typename decltype(tag)::type;
+          builder.write(*static_cast<const T *>(last.data.get()));
+        });
+      }
+      builder.finish_array();
+    }
+    else
+    {
+      copy(builder, mpack_node_array_at(root_, 1));
+    }
     builder.finish_array();
   }
 
 private:
   int8_t version_ = 0;
   bool valid_ = true;
+  bool checkpoint_ = false;
+  std::vector<TypedKey> * keys_out_;
   mpack_node_t root_;
   std::vector<FlatLog::record> records_;
 
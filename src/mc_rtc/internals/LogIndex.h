@@ -0,0 +1,112 @@
+/*
+ * Copyright 2015-2021 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/log/Logger.h>
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace mc_rtc
+{
+
+namespace log
+{
+
+namespace internal
+{
+
+/** A checkpoint in a binary log: a frame that holds the full key table and every value */
+struct LogCheckpoint
+{
+  /** Offset of the frame in the log file */
+  uint64_t offset;
+  /** Index of the frame in the log */
+  uint64_t iteration;
+  /** Time of the frame */
+  double t;
+};
+
+/** Index of a binary log
+ *
+ * The file layout is:
+ * - the log magic number and version;
+ * - the size of the indexed log in bytes;
+ * - the number of frames in the log;
+ * - the number of checkpoints followed by the checkpoints
+ */
+struct LogIndex
+{
+  /** Size of the indexed log, used to detect outdated indexes */
+  uint64_t log_size = 0;
+  /** Number of frames in the log */
+  uint64_t frames = 0;
+  /** Checkpoints sorted by iteration */
+  std::vector<LogCheckpoint> checkpoints;
+
+  /** Write the index to \p path, returns false on failure */
+  bool save(const std::string & path) const
+  {
+    std::ofstream ofs(path, std::ofstream::binary);
+    if(!ofs)
+    {
+      return false;
+    }
+    const char version = static_cast<char>(Logger::magic[3] + Logger::version);
+    ofs.write((const char *)&Logger::magic, sizeof(Logger::magic) - sizeof(uint8_t));
+    ofs.write(&version, sizeof(uint8_t));
+    uint64_t size = checkpoints.size();
+    ofs.write((const char *)&log_size, sizeof(uint64_t));
+    ofs.write((const char *)&frames, sizeof(uint64_t));
+    ofs.write((const char *)&size, sizeof(uint64_t));
+    for(const auto & c : checkpoints)
+    {
+      ofs.write((const char *)&c.offset, sizeof(uint64_t));
+      ofs.write((const char *)&c.iteration, sizeof(uint64_t));
+      ofs.write((const char *)&c.t, sizeof(double));
+    }
+    return static_cast<bool>(ofs);
+  }
+
+  /** Read the index from \p path, returns false if the file does not exist or is not a valid index */
+  bool load(const std::string & path)
+  {
+    std::ifstream ifs(path, std::ifstream::binary);
+    if(!ifs)
+    {
+      return false;
+    }
+    char magic[sizeof(Logger::magic)];
+    ifs.read(magic, sizeof(magic));
+    if(!ifs || memcmp(magic, &Logger::magic, sizeof(Logger::magic) - 1) != 0)
+    {
+      return false;
+    }
+    uint64_t size = 0;
+    ifs.read((char *)&log_size, sizeof(uint64_t));
+    ifs.read((char *)&frames, sizeof(uint64_t));
+    ifs.read((char *)&size, sizeof(uint64_t));
+    // Every frame takes at least 8 bytes in the log
+    if(!ifs || size > frames || frames > log_size / sizeof(uint64_t))
+    {
+      return false;
+    }
+    checkpoints.resize(size);
+    for(auto & c : checkpoints)
+    {
+      ifs.read((char *)&c.offset, sizeof(uint64_t));
+      ifs.read((char *)&c.iteration, sizeof(uint64_t));
+      ifs.read((char *)&c.t, sizeof(double));
+    }
+    return static_cast<bool>(ifs);
+  }
+};
+
+} // namespace internal
+
+} // namespace log
+
+} // namespace mc_rtc
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2015-2021 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#pragma once
+
+#include <mc_rtc/log/utils.h>
+
+namespace mc_rtc
+{
+
+namespace log
+{
+
+namespace internal
+{
+
+/** Helper to carry a type in a value */
+template<typename T>
+struct type_tag
+{
+  using type = T;
+};
+
+/** Call \p cb with a type_tag for the C++ type used to store \p type (see log::LogStorage)
+ *
+ * \p cb is not called if \p type is not a valid type
+ */
+template<typename Callback>
+void visit_storage(log::LogType type, Callback && cb)
+{
+  switch(type)
+  {
+#define CASE_STORAGE(ENUMV)                                              \
+  case log::LogType::ENUMV:                                              \
+    cb(type_tag<typename log::LogStorage<log::LogType::ENUMV>::type>{}); \
+    break;
+    CASE_STORAGE(Bool)
+    CASE_STORAGE(Int8_t)
+    CASE_STORAGE(Int16_t)
+    CASE_STORAGE(Int32_t)
+    CASE_STORAGE(Int64_t)
+    CASE_STORAGE(Uint8_t)
+    CASE_STORAGE(Uint16_t)
+    CASE_STORAGE(Uint32_t)
+    CASE_STORAGE(Uint64_t)
+    CASE_STORAGE(Float)
+    CASE_STORAGE(Double)
+    CASE_STORAGE(String)
+    CASE_STORAGE(Vector2d)
+    CASE_STORAGE(Vector3d)
+    CASE_STORAGE(Vector6d)
+    CASE_STORAGE(VectorXd)
+    CASE_STORAGE(Quaterniond)
+    CASE_STORAGE(PTransformd)
+    CASE_STORAGE(ForceVecd)
+    CASE_STORAGE(MotionVecd)
+    CASE_STORAGE(VectorDouble)
+#undef CASE_STORAGE
+    case log::LogType::None:
+    default:
+      break;
+  }
+}
+
+} // namespace internal
+
+} // namespace log
+
+} // namespace mc_rtc
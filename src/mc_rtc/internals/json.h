@@ -44,6 +44,11 @@ namespace internal
 using RapidJSONDocument = rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator>;
 using RapidJSONValue = rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>;
 
+/** Allocator of the documents that are only read once, see Configuration::ScratchData */
+using RapidJSONScratchAllocator = rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>;
+using RapidJSONScratchDocument =
+    rapidjson::GenericDocument<rapidjson::UTF8<>, RapidJSONScratchAllocator, RapidJSONScratchAllocator>;
+
 /*! Load JSON data into the provided rapidjson::Document
  *
  * \param data JSON data to load
@@ -55,7 +60,8 @@ using RapidJSONValue = rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::Crt
  * \returns True if the document was succesfully loaded, returns false and
  * display an error message otherwise
  */
-inline bool loadData(const char * data, RapidJSONDocument & document, const std::string & path = "")
+template<typename DocumentT>
+bool loadData(const char * data, DocumentT & document, const std::string & path = "")
 {
   rapidjson::ParseResult res = document.Parse(data);
   if(!res)
@@ -193,6 +199,78 @@ inline static void toMessagePack(const RapidJSONValue & value, MessagePackBuilde
   }
 }
 
+/** Convert MessagePack data into a RapidJSON value
+ *
+ * This builds the value directly rather than going through the Configuration API
+ *
+ * \returns False if the node holds a type that cannot be represented
+ */
+inline bool fromMessagePack(mpack_node_t node, RapidJSONValue & out, RapidJSONDocument::AllocatorType & allocator)
+{
+  switch(mpack_node_type(node))
+  {
+    case mpack_type_nil:
+      out.SetNull();
+      return true;
+    case mpack_type_bool:
+      out.SetBool(mpack_node_bool(node));
+      return true;
+    case mpack_type_int:
+      out.SetInt64(mpack_node_i64(node));
+      return true;
+    case mpack_type_uint:
+      out.SetUint64(mpack_node_u64(node));
+      return true;
+    case mpack_type_float:
+      out.SetDouble(mpack_node_float(node));
+      return true;
+    case mpack_type_double:
+      out.SetDouble(mpack_node_double(node));
+      return true;
+    case mpack_type_str:
+      out.SetString(mpack_node_str(node), static_cast<rapidjson::SizeType>(mpack_node_strlen(node)), allocator);
+      return true;
+    case mpack_type_array:
+    {
+      auto size = static_cast<rapidjson::SizeType>(mpack_node_array_length(node));
+      out.SetArray();
+      out.Reserve(size, allocator);
+      for(rapidjson::SizeType i = 0; i < size; ++i)
+      {
+        RapidJSONValue value;
+        if(!fromMessagePack(mpack_node_array_at(node, i), value, allocator))
+        {
+          return false;
+        }
+        out.PushBack(value, allocator);
+      }
+      return true;
+    }
+    case mpack_type_map:
+    {
+      out.SetObject();
+      for(size_t i = 0; i < mpack_node_map_count(node); ++i)
+      {
+        auto key = mpack_node_map_key_at(node, i);
+        if(mpack_node_type(key) != mpack_type_str)
+        {
+          return false;
+        }
+        RapidJSONValue name(mpack_node_str(key), static_cast<rapidjson::SizeType>(mpack_node_strlen(key)), allocator);
+        RapidJSONValue value;
+        if(!fromMessagePack(mpack_node_map_value_at(node, i), value, allocator))
+        {
+          return false;
+        }
+        out.AddMember(name, value, allocator);
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
 namespace
 {
 
@@ -76,6 +76,8 @@ LTDLHandle::LTDLHandle(const std::string & class_name,
 bool LTDLHandle::open()
 {
 #ifndef MC_RTC_BUILD_STATIC
+  // The handle can be shared by objects created from different threads
+  std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
   if(open_)
   {
     return true;
@@ -97,7 +99,6 @@ bool LTDLHandle::open()
     {
       mc_rtc::log::info("Opening {} in global mode", path_);
     }
-    std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
     lt_dladvise advise;
     lt_dladvise_init(&advise);
     lt_dladvise_global(&advise);
@@ -106,19 +107,14 @@ bool LTDLHandle::open()
   }
   else
   {
-    std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
     handle_ = lt_dlopen(path_.c_str());
   }
 #  else
-  {
-    std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
-    handle_ = lt_dlopen(path_.c_str());
-  }
+  handle_ = lt_dlopen(path_.c_str());
 #  endif
   open_ = handle_ != nullptr;
   if(!open_)
   {
-    std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
     const char * error = lt_dlerror();
     /* Discard the "file not found" error as it only indicates that we tried to load something other than a library */
     if(strcmp(error, "file not found") != 0)
@@ -138,10 +134,10 @@ bool LTDLHandle::open()
 void LTDLHandle::close()
 {
 #ifndef MC_RTC_BUILD_STATIC
+  std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
   if(open_)
   {
     open_ = false;
-    std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
     lt_dlclose(handle_);
   }
 #endif
@@ -179,10 +175,10 @@ bool Loader::init()
 bool Loader::close()
 {
 #ifndef MC_RTC_BUILD_STATIC
+  std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
   --init_count_;
   if(init_count_ == 0)
   {
-    std::unique_lock<std::mutex> lock{LTDLMutex::MTX};
     int err = lt_dlexit();
     if(err != 0)
     {
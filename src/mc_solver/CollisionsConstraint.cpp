@@ -17,6 +17,8 @@
 #include <mc_rtc/gui/Checkbox.h>
 #include <mc_rtc/gui/Label.h>
 
+#include <mc_rtc/WorkerPool.h>
+
 #include <Tasks/QPConstr.h>
 
 #include <tvm/task_dynamics/VelocityDamper.h>
@@ -34,6 +36,8 @@ struct TVMCollisionConstraint
     CollisionData(int id, const mc_rbdyn::Collision & col) : id(id), collision(col) {}
     int id;
     mc_rbdyn::Collision collision;
+    mc_tvm::Convex * c1 = nullptr;
+    mc_tvm::Convex * c2 = nullptr;
     mc_tvm::CollisionFunctionPtr function;
     tvm::TaskWithRequirementsPtr task;
   };
@@ -41,6 +45,56 @@ struct TVMCollisionConstraint
   std::vector<CollisionData> data_;
   /** Solver this has been added to */
   mc_solver::TVMQPSolver * solver;
+  /** Margin added to the interaction distance to skip the exact distance computation */
+  double cullingMargin = mc_solver::CollisionsConstraint::defaultCullingMargin;
+  /** Workers used to evaluate the collisions before the solve, if any */
+  std::unique_ptr<mc_rtc::WorkerPool> pool;
+
+  /** Evaluate the collisions in the problem on the worker pool */
+  void evaluate()
+  {
+    // Convexes and frames can be shared by several collisions so they are updated (and the frames' cached positions
+    // refreshed) on this thread before the parallel evaluation, a convex that was already updated for the current
+    // kinematics is skipped here and in the computation graph
+    for(auto & d : data_)
+    {
+      if(d.task)
+      {
+        d.c1->update();
+        d.c2->update();
+      }
+    }
+    pool->run(data_.size(), [this](size_t i) {
+      auto & d = data_[i];
+      if(d.task)
+      {
+        d.function->precompute();
+      }
+      else if(d.function)
+      {
+        // Not in the problem, the graph would use stale results if the collision is added back later
+        d.function->discardPrecomputed();
+      }
+    });
+  }
+
+  void setParallel(size_t threads, const std::vector<int> & cpus, std::chrono::microseconds spin)
+  {
+    if(solver)
+    {
+      solver->removePreSolveCallback(this);
+    }
+    pool.reset();
+    if(threads == 0)
+    {
+      return;
+    }
+    pool = std::make_unique<mc_rtc::WorkerPool>(threads, cpus, spin);
+    if(solver)
+    {
+      solver->addPreSolveCallback(this, [this]() { evaluate(); });
+    }
+  }
 
   auto getData(const mc_rbdyn::Collision & col)
   {
@@ -60,6 +114,10 @@ struct TVMCollisionConstraint
     {
       return data_.end();
     }
+    if(it->function)
+    {
+      it->function->discardPrecomputed();
+    }
     if(it->task)
     {
       solver.problem().remove(*it->task);
@@ -122,10 +180,27 @@ struct TVMCollisionConstraint
     auto & data = data_.back();
     auto & c1 = r1.tvmConvex(col.body1);
     auto & c2 = r2.tvmConvex(col.body2);
+    data.c1 = &c1;
+    data.c2 = &c2;
     data.function = std::make_shared<mc_tvm::CollisionFunction>(c1, c2, r1Selector, r2Selector, solver.dt());
+    updateCulling(data);
     return data;
   }
 
+  void updateCulling(CollisionData & data)
+  {
+    data.function->cullingDistance(cullingMargin < 0 ? -1.0 : data.collision.iDist + cullingMargin);
+  }
+
+  void setCullingMargin(double margin)
+  {
+    cullingMargin = margin;
+    for(auto & d : data_)
+    {
+      updateCulling(d);
+    }
+  }
+
   void addCollision(TVMQPSolver & solver, CollisionData & data)
   {
     const auto & col = data.collision;
@@ -436,8 +511,14 @@ void CollisionsConstraint::toggleCollisionMonitor(int collId)
   }
   else
   {
-    auto addMonitor = [&](auto && distance_callback, auto && p1_callback, auto && p2_callback) {
-      gui.addElement(category_, mc_rtc::gui::Label(label, [distance_callback]() {
+    auto addMonitor = [&](auto && distance_callback, auto && culled_callback, auto && p1_callback,
+                          auto && p2_callback) {
+      gui.addElement(category_, mc_rtc::gui::Label(label, [distance_callback, culled_callback]() {
+                       if(culled_callback())
+                       {
+                         // The distance and the points are those of the bounding spheres
+                         return fmt::format("> {:0.2f} cm (culled)", distance_callback());
+                       }
                        return fmt::format("{:0.2f} cm", distance_callback());
                      }));
       category_.push_back("Arrows");
@@ -451,6 +532,7 @@ void CollisionsConstraint::toggleCollisionMonitor(int collId)
         auto collConstr = tasks_constraint(constraint_);
         addMonitor(
             [collConstr, collId]() { return collConstr->getCollisionData(collId).distance * 100; },
+            []() { return false; },
             [collConstr, collId]() -> const Eigen::Vector3d & { return collConstr->getCollisionData(collId).p1; },
             [collConstr, collId]() -> const Eigen::Vector3d & { return collConstr->getCollisionData(collId).p2; });
         category_.pop_back();
@@ -460,7 +542,8 @@ void CollisionsConstraint::toggleCollisionMonitor(int collId)
       {
         auto collConstr = tvm_constraint(constraint_);
         auto fn = collConstr->getData(collId)->function;
-        addMonitor([fn]() { return fn->distance(); }, [fn]() -> const Eigen::Vector3d & { return fn->p1(); },
+        addMonitor([fn]() { return fn->distance() * 100; }, [fn]() { return fn->culled(); },
+                   [fn]() -> const Eigen::Vector3d & { return fn->p1(); },
                    [fn]() -> const Eigen::Vector3d & { return fn->p2(); });
         break;
       }
@@ -517,7 +600,11 @@ void CollisionsConstraint::addToSolverImpl(QPSolver & solver)
       {
         tvm_constraint(constraint_)->addCollision(tvm_solver(solver), c);
       }
-      tvm_constraint(constraint_)->solver = &tvm_solver(solver);
+      cstr->solver = &tvm_solver(solver);
+      if(cstr->pool)
+      {
+        cstr->solver->addPreSolveCallback(cstr, [cstr]() { cstr->evaluate(); });
+      }
       break;
     }
     default:
@@ -543,6 +630,7 @@ void CollisionsConstraint::removeFromSolverImpl(QPSolver & solver)
     case QPSolver::Backend::TVM:
     {
       tvm_constraint(constraint_)->removeCollisions(tvm_solver(solver));
+      tvm_solver(solver).removePreSolveCallback(tvm_constraint(constraint_));
       tvm_constraint(constraint_)->solver = nullptr;
       break;
     }
@@ -552,6 +640,49 @@ void CollisionsConstraint::removeFromSolverImpl(QPSolver & solver)
   gui_->removeCategory(category_);
 }
 
+void CollisionsConstraint::cullingMargin(double margin)
+{
+  cullingMargin_ = margin;
+  switch(backend_)
+  {
+    case QPSolver::Backend::TVM:
+      tvm_constraint(constraint_)->setCullingMargin(margin);
+      break;
+    default:
+      mc_rtc::log::warning("[CollisionConstr] Culling is not implemented for solver backend: {}, the exact distance of "
+                           "every pair is computed",
+                           backend_);
+      break;
+  }
+}
+
+void CollisionsConstraint::parallel(size_t threads, const std::vector<int> & cpus, std::chrono::microseconds spin)
+{
+  switch(backend_)
+  {
+    case QPSolver::Backend::TVM:
+      tvm_constraint(constraint_)->setParallel(threads, cpus, spin);
+      break;
+    default:
+      mc_rtc::log::warning("[CollisionConstr] Parallel evaluation is not implemented for solver backend: {}", backend_);
+      break;
+  }
+}
+
+size_t CollisionsConstraint::parallel() const noexcept
+{
+  switch(backend_)
+  {
+    case QPSolver::Backend::TVM:
+    {
+      const auto & pool = tvm_constraint(constraint_)->pool;
+      return pool ? pool->size() : 0;
+    }
+    default:
+      return 0;
+  }
+}
+
 void CollisionsConstraint::reset()
 {
   cols.clear();
@@ -616,6 +747,16 @@ static auto registered = mc_solver::ConstraintSetLoader::register_load_function(
       auto ret = std::make_shared<mc_solver::CollisionsConstraint>(
           solver.robots(), robotIndexFromConfig(config, solver.robots(), "collision", false, "r1Index", "r1", ""),
           robotIndexFromConfig(config, solver.robots(), "collision", false, "r2Index", "r2", ""), solver.dt());
+      if(config.has("cullingMargin"))
+      {
+        ret->cullingMargin(config("cullingMargin"));
+      }
+      if(config.has("threads"))
+      {
+        size_t threads = config("threads");
+        int64_t spin = config("spin", static_cast<int64_t>(mc_rtc::WorkerPool::default_spin.count()));
+        ret->parallel(threads, config("cpus", std::vector<int>{}), std::chrono::microseconds{spin});
+      }
       if(ret->r1Index == ret->r2Index)
       {
         if(config("useCommon", false))
@@ -10,6 +10,8 @@
 #include <mc_rbdyn/Surface.h>
 #include <mc_tasks/MetaTask.h>
 
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/Tracing.h>
 #include <mc_rtc/gui/Button.h>
 #include <mc_rtc/gui/Force.h>
 #include <mc_rtc/gui/Form.h>
@@ -140,6 +142,8 @@ const std::vector<mc_tasks::MetaTask *> & QPSolver::tasks() const
 
 bool QPSolver::run(FeedbackType fType)
 {
+  MC_RTC_TRACE_SPAN("QPSolver::run");
+  mc_rtc::alloc::Scope alloc_scope("QPSolver::run");
   return run_impl(fType);
 }
 
@@ -11,6 +11,7 @@
 #include <mc_tvm/ContactFunction.h>
 #include <mc_tvm/Robot.h>
 
+#include <mc_rtc/Tracing.h>
 #include <mc_rtc/gui/Force.h>
 
 #include <tvm/solver/defaultLeastSquareSolver.h>
@@ -105,6 +106,18 @@ double TVMQPSolver::solveAndBuildTime()
   return solve_dt_.count();
 }
 
+void TVMQPSolver::addPreSolveCallback(const void * owner, std::function<void()> callback)
+{
+  preSolve_.push_back({owner, std::move(callback)});
+}
+
+void TVMQPSolver::removePreSolveCallback(const void * owner)
+{
+  preSolve_.erase(
+      std::remove_if(preSolve_.begin(), preSolve_.end(), [&](const auto & cb) { return cb.first == owner; }),
+      preSolve_.end());
+}
+
 bool TVMQPSolver::run_impl(FeedbackType fType)
 {
   switch(fType)
@@ -129,10 +142,17 @@ bool TVMQPSolver::runCommon()
 {
   for(auto & t : metaTasks_)
   {
+    MC_RTC_TRACE_SPAN("MetaTask::update", t->name());
     t->update(*this);
     t->incrementIterInSolver();
   }
+  for(auto & cb : preSolve_)
+  {
+    MC_RTC_TRACE_SPAN("TVMQPSolver::preSolve");
+    cb.second();
+  }
   auto start_t = mc_rtc::clock::now();
+  MC_RTC_TRACE_SPAN("QPSolver::solve");
   auto r = solver_.solve(problem_);
   solve_dt_ = mc_rtc::clock::now() - start_t;
   return r;
@@ -1,5 +1,6 @@
 #include <mc_solver/TasksQPSolver.h>
 
+#include <mc_rtc/Tracing.h>
 #include <mc_rtc/gui.h>
 #include <mc_rtc/log/Logger.h>
 
@@ -195,14 +196,21 @@ bool TasksQPSolver::run_impl(FeedbackType fType)
   return success;
 }
 
+bool TasksQPSolver::solve()
+{
+  MC_RTC_TRACE_SPAN("QPSolver::solve");
+  return solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs());
+}
+
 bool TasksQPSolver::runOpenLoop()
 {
   for(auto & t : metaTasks_)
   {
+    MC_RTC_TRACE_SPAN("MetaTask::update", t->name());
     t->update(*this);
     t->incrementIterInSolver();
   }
-  if(solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs()))
+  if(solve())
   {
     for(size_t i = 0; i < robots_p->mbs().size(); ++i)
     {
@@ -274,10 +282,11 @@ bool TasksQPSolver::runJointsFeedback(bool wVelocity)
   }
   for(auto & t : metaTasks_)
   {
+    MC_RTC_TRACE_SPAN("MetaTask::update", t->name());
     t->update(*this);
     t->incrementIterInSolver();
   }
-  if(solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs()))
+  if(solve())
   {
     for(size_t i = 0; i < robots_p->mbs().size(); ++i)
     {
@@ -329,12 +338,13 @@ bool TasksQPSolver::runClosedLoop(bool integrateControlState)
   // Update tasks from estimated robots
   for(auto & t : metaTasks_)
   {
+    MC_RTC_TRACE_SPAN("MetaTask::update", t->name());
     t->update(*this);
     t->incrementIterInSolver();
   }
 
   // Solve QP and integrate
-  if(solver_.solveNoMbcUpdate(robots_p->mbs(), robots_p->mbcs()))
+  if(solve())
   {
     for(size_t i = 0; i < robots_p->mbs().size(); ++i)
     {
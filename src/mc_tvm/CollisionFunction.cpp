@@ -71,16 +71,54 @@ CollisionFunction::CollisionFunction(Convex & c1,
   distJac_.resize(1, maxDof);
 }
 
+void CollisionFunction::precompute()
+{
+  computeValue();
+  computeJacobian();
+  valueReady_ = true;
+  jacobianReady_ = true;
+}
+
 void CollisionFunction::updateValue()
 {
-  double dist = sch::mc_rbdyn::distance(pair_, p1_, p2_);
-  if(dist == 0)
+  if(valueReady_)
   {
-    dist = sch::epsilon;
+    valueReady_ = false;
+    return;
+  }
+  computeValue();
+}
+
+void CollisionFunction::computeValue()
+{
+  bool wasCulled = culled_;
+  culled_ = false;
+  double dist = 0;
+  if(cullingDistance_ >= 0)
+  {
+    // Broad phase: lower bound of the distance given by the bounding spheres
+    Eigen::Vector3d c2_c1 = c1_->boundingCenter() - c2_->boundingCenter();
+    double centers = c2_c1.norm();
+    dist = centers - c1_->boundingRadius() - c2_->boundingRadius();
+    if(dist > cullingDistance_)
+    {
+      culled_ = true;
+      p1_ = c1_->boundingCenter() - (c1_->boundingRadius() / centers) * c2_c1;
+      p2_ = c2_->boundingCenter() + (c2_->boundingRadius() / centers) * c2_c1;
+    }
+  }
+  if(!culled_)
+  {
+    dist = sch::mc_rbdyn::distance(pair_, p1_, p2_);
+    if(dist == 0)
+    {
+      dist = sch::epsilon;
+    }
+    dist = dist >= 0 ? std::sqrt(dist) : -std::sqrt(-dist);
   }
-  dist = dist >= 0 ? std::sqrt(dist) : -std::sqrt(-dist);
   normVecDist_ = (p1_ - p2_) / dist;
-  if(iter_ == 1)
+  // The normal of a culled pair joins the bounding spheres' centers, do not derive it when the exact distance resumes
+  if(iter_ == 1 || (wasCulled && !culled_))
   {
     prevNormVecDist_ = normVecDist_;
   }
@@ -95,7 +133,7 @@ void CollisionFunction::updateValue()
   for(size_t i = 0; i < data_.size(); ++i)
   {
     auto & d = data_[i];
-    d.nearestPoint_ = (sva::PTransformd(point) * object.get()->frame().position().inv()).translation();
+    d.nearestPoint_ = (sva::PTransformd(point) * object.get()->framePosition().inv()).translation();
     d.jac_.point(d.nearestPoint_);
     object = std::ref(c2_);
     point = std::ref(p2_);
@@ -106,14 +144,30 @@ void CollisionFunction::updateValue()
 void CollisionFunction::tick()
 {
   iter_++;
+  discardPrecomputed();
 }
 
 void CollisionFunction::updateJacobian()
+{
+  if(jacobianReady_)
+  {
+    jacobianReady_ = false;
+    return;
+  }
+  computeJacobian();
+}
+
+void CollisionFunction::computeJacobian()
 {
   for(int i = 0; i < variables_.numberOfVariables(); ++i)
   {
     jacobian_[variables_[i].get()].setZero();
   }
+  if(culled_)
+  {
+    // The pair is out of the interaction distance, see updateVelocity and updateNormalAcceleration
+    return;
+  }
   double sign = 1.0;
   auto object = std::ref(c1_);
   auto point = std::ref(p1_);
@@ -143,6 +197,10 @@ void CollisionFunction::updateJacobian()
 void CollisionFunction::updateVelocity()
 {
   velocity_(0) = 0;
+  if(culled_)
+  {
+    return;
+  }
   double sign = 1.0;
   auto object = std::ref(c1_);
   auto point = std::ref(p1_);
@@ -160,6 +218,10 @@ void CollisionFunction::updateVelocity()
 void CollisionFunction::updateNormalAcceleration()
 {
   normalAcceleration_(0) = 0;
+  if(culled_)
+  {
+    return;
+  }
   double sign = 1.0;
   auto object = std::ref(c1_);
   auto point = std::ref(p1_);
@@ -18,11 +18,52 @@ Convex::Convex(NewConvexToken,
   registerUpdates(Update::Position, &Convex::updatePosition);
   addInputDependency(Update::Position, tvm_frame, Frame::Output::Position);
   addOutputDependency(Output::Position, Update::Position);
+  // The support points along the axes give the exact axis-aligned bounding box of the object in its own frame
+  sch::mc_rbdyn::transform(*object_, sva::PTransformd::Identity());
+  Eigen::Vector3d lower, upper;
+  for(size_t i = 0; i < 3; ++i)
+  {
+    sch::Vector3 dir(0, 0, 0);
+    dir[i] = 1;
+    upper(static_cast<Eigen::Index>(i)) = object_->support(dir)[i];
+    dir[i] = -1;
+    lower(static_cast<Eigen::Index>(i)) = object_->support(dir)[i];
+  }
+  localCenter_ = 0.5 * (lower + upper);
+  radius_ = 0.5 * (upper - lower).norm();
+  X_0_f_ = frame.position();
+  generation_ = frame.robot().kinematicsGeneration();
+  sva::PTransformd X_0_c = X_f_c_ * X_0_f_;
+  sch::mc_rbdyn::transform(*object_, X_0_c);
+  center_ = (sva::PTransformd(localCenter_) * X_0_c).translation();
+}
+
+void Convex::update()
+{
+  uint64_t generation = frame_->robot().kinematicsGeneration();
+  if(generation == generation_)
+  {
+    return;
+  }
+  generation_ = generation;
+  X_0_f_ = frame_->position();
+  sva::PTransformd X_0_c = X_f_c_ * X_0_f_;
+  sch::mc_rbdyn::transform(*object_, X_0_c);
+  center_ = (sva::PTransformd(localCenter_) * X_0_c).translation();
 }
 
 void Convex::updatePosition()
 {
-  sch::mc_rbdyn::transform(*object_, X_f_c_ * frame_->tvm_frame().position());
+  uint64_t generation = frame_->robot().kinematicsGeneration();
+  if(generation == generation_)
+  {
+    return;
+  }
+  generation_ = generation;
+  X_0_f_ = frame_->tvm_frame().position();
+  sva::PTransformd X_0_c = X_f_c_ * X_0_f_;
+  sch::mc_rbdyn::transform(*object_, X_0_c);
+  center_ = (sva::PTransformd(localCenter_) * X_0_c).translation();
 }
 
 } // namespace mc_tvm
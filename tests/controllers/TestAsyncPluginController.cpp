@@ -0,0 +1,69 @@
+/*
+ * Copyright 2015-2022 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#ifdef BOOST_TEST_MAIN
+#  undef BOOST_TEST_MAIN
+#endif
+#include <mc_control/api.h>
+#include <mc_control/mc_controller.h>
+#include <mc_rtc/logging.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace mc_control
+{
+
+struct MC_CONTROL_DLLAPI TestAsyncPluginController : public MCController
+{
+public:
+  TestAsyncPluginController(std::shared_ptr<mc_rbdyn::RobotModule> rm, double dt, Backend backend)
+  : MCController(rm, dt, backend)
+  {
+    solver().addConstraintSet(kinematicsConstraint);
+    postureTask->stiffness(1);
+    postureTask->weight(1);
+    solver().addTask(postureTask.get());
+    mc_rtc::log::success("Created TestAsyncPluginController");
+  }
+
+  bool run() override
+  {
+    // The asynchronous plugin publishes the number of processed captures before the controller runs
+    BOOST_REQUIRE(datastore().has("TestAsyncPluginController::processed"));
+    auto processed = datastore().get<size_t>("TestAsyncPluginController::processed");
+    // Captures happen after the controller run so at most nrIter captures have been processed
+    BOOST_REQUIRE(processed <= nrIter);
+    BOOST_REQUIRE(processed >= processed_);
+    processed_ = processed;
+    auto njoints = robot().mbc().q.size();
+    size_t jIdx = 0;
+    for(const auto & j : robot().mb().joints())
+    {
+      if(j.dof() == 1)
+      {
+        target_[j.name()] = {std::cos(static_cast<double>(jIdx) / static_cast<double>(njoints) + nrIter / 2000.)};
+      }
+      jIdx++;
+    }
+    postureTask->target(target_);
+    bool ret = MCController::run();
+    BOOST_CHECK(ret);
+    nrIter++;
+    return ret;
+  }
+
+private:
+  size_t nrIter = 0;
+  size_t processed_ = 0;
+  std::map<std::string, std::vector<double>> target_;
+};
+
+} // namespace mc_control
+
+using Controller = mc_control::TestAsyncPluginController;
+using Backend = mc_control::MCController::Backend;
+MULTI_CONTROLLERS_CONSTRUCTOR("TestAsyncPluginController",
+                              Controller(rm, dt, Backend::Tasks),
+                              "TestAsyncPluginController_TVM",
+                              Controller(rm, dt, Backend::TVM))
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2015-2022 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/GlobalPluginMacros.h>
+
+#ifdef BOOST_TEST_MAIN
+#  undef BOOST_TEST_MAIN
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace mc_plugin
+{
+
+/** Checks the capture/process protocol of asynchronous plugins
+ *
+ * Boost.Test is not thread-safe so \ref process only records its failures, they are reported on the control thread
+ */
+struct MC_CONTROL_DLLAPI TestAsyncPluginController : public mc_control::GlobalPlugin
+{
+  GlobalPluginConfiguration configuration() override
+  {
+    GlobalPluginConfiguration out;
+    out.async = true;
+    return out;
+  }
+
+  void init(mc_control::MCGlobalController & gc, const mc_rtc::Configuration &) override
+  {
+    reset(gc);
+  }
+
+  void reset(mc_control::MCGlobalController & gc) override
+  {
+    // The global controller waits for the pending processing before resetting the plugins
+    BOOST_REQUIRE(!processing_);
+    BOOST_REQUIRE_EQUAL(processed_.load(), captured_);
+    gc.controller().datastore().make<size_t>("TestAsyncPluginController::processed", processed_.load());
+  }
+
+  void before(mc_control::MCGlobalController & gc) override
+  {
+    BOOST_REQUIRE(!process_failed_);
+    size_t processed = processed_.load();
+    // At most one capture is waiting to be processed
+    BOOST_REQUIRE(processed <= captured_);
+    BOOST_REQUIRE(captured_ <= processed + 1);
+    if(++iter_ == 100)
+    {
+      // Give the processing thread a chance to run if the control thread starved it until now
+      for(size_t i = 0; i < 1000 && processed_ == 0; ++i)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      processed = processed_.load();
+      BOOST_REQUIRE(processed > 0);
+    }
+    gc.controller().datastore().assign("TestAsyncPluginController::processed", processed);
+  }
+
+  void after(mc_control::MCGlobalController &) override
+  {
+    BOOST_FAIL("after should not be called for an asynchronous plugin");
+  }
+
+  void capture(mc_control::MCGlobalController & gc) override
+  {
+    // capture is only called once the previous capture has been processed
+    BOOST_REQUIRE(!processing_);
+    BOOST_REQUIRE_EQUAL(processed_.load(), captured_);
+    com_ = gc.controller().robot().com();
+    captured_++;
+  }
+
+  void process() override
+  {
+    processing_ = true;
+    if(!com_.allFinite())
+    {
+      process_failed_ = true;
+    }
+    processed_++;
+    processing_ = false;
+  }
+
+private:
+  /** Data captured on the control thread and used by process */
+  Eigen::Vector3d com_ = Eigen::Vector3d::Zero();
+  /** Number of calls to before, only used on the control thread */
+  size_t iter_ = 0;
+  /** Number of captures, only modified on the control thread */
+  size_t captured_ = 0;
+  std::atomic<size_t> processed_{0};
+  std::atomic<bool> processing_{false};
+  std::atomic<bool> process_failed_{false};
+};
+
+} // namespace mc_plugin
+
+extern "C"
+{
+
+  GLOBAL_PLUGIN_API void MC_RTC_GLOBAL_PLUGIN(std::vector<std::string> & names)
+  {
+    names = {"TestAsyncPluginController"};
+  }
+
+  GLOBAL_PLUGIN_API void destroy(mc_control::GlobalPlugin * ptr)
+  {
+    delete ptr;
+  }
+
+  GLOBAL_PLUGIN_API mc_control::GlobalPlugin * create(const std::string &)
+  {
+    return new mc_plugin::TestAsyncPluginController();
+  }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_rtc/AllocationTracker.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <thread>
+
+#include <malloc.h>
+
+// Called through volatile pointers so that the compiler cannot elide the allocations
+static void * (*volatile do_malloc)(size_t) = std::malloc;
+static void (*volatile do_free)(void *) = std::free;
+
+static const mc_rtc::alloc::StageStatistics * findStage(const std::vector<mc_rtc::alloc::StageStatistics> & stats,
+                                                        const std::string & name)
+{
+  for(const auto & s : stats)
+  {
+    if(s.name == name)
+    {
+      return &s;
+    }
+  }
+  return nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(TestAllocationTracker)
+{
+  // The test is linked to mc_rtc_alloc_hooks
+  BOOST_REQUIRE(mc_rtc::alloc::available());
+  BOOST_REQUIRE(mc_rtc::alloc::enabled());
+  mc_rtc::alloc::captureStacks(3);
+  mc_rtc::alloc::reset();
+
+  // Outside of a scope
+  do_free(do_malloc(64));
+  BOOST_REQUIRE(mc_rtc::alloc::allocations() == 0);
+
+  {
+    mc_rtc::alloc::Scope outer("outer");
+    void * ptr = do_malloc(128);
+    {
+      mc_rtc::alloc::Scope inner("inner");
+      do_free(do_malloc(16));
+      do_free(do_malloc(16));
+    }
+    do_free(ptr);
+    // Only the calling thread is tracked
+    std::thread([]() { do_free(do_malloc(32)); }).join();
+  }
+  BOOST_REQUIRE(mc_rtc::alloc::allocations() >= 3);
+  auto stats = mc_rtc::alloc::statistics();
+  auto outer = findStage(stats, "outer");
+  BOOST_REQUIRE(outer);
+  // std::thread allocates its state in the outer scope
+  BOOST_CHECK(outer->allocations >= 1);
+  BOOST_CHECK(outer->bytes >= 128);
+  BOOST_CHECK(outer->deallocations >= 1);
+  auto inner = findStage(stats, "inner");
+  BOOST_REQUIRE(inner);
+  BOOST_CHECK_EQUAL(inner->allocations, 2);
+  BOOST_CHECK_EQUAL(inner->deallocations, 2);
+  BOOST_CHECK_EQUAL(inner->bytes, 32);
+  auto stacks = mc_rtc::alloc::stacks();
+  BOOST_REQUIRE_EQUAL(stacks.size(), 3);
+  BOOST_CHECK_EQUAL(stacks[0].stage, "outer");
+  BOOST_CHECK_EQUAL(stacks[0].size, 128);
+  BOOST_CHECK_EQUAL(stacks[1].stage, "inner");
+  BOOST_CHECK(stacks[1].stack.size());
+
+  // Disabled tracking
+  mc_rtc::alloc::reset();
+  BOOST_CHECK(mc_rtc::alloc::stacks().empty());
+  mc_rtc::alloc::enable(false);
+  {
+    mc_rtc::alloc::Scope scope("outer");
+    do_free(do_malloc(64));
+  }
+  BOOST_CHECK_EQUAL(mc_rtc::alloc::allocations(), 0);
+  mc_rtc::alloc::enable(true);
+  mc_rtc::alloc::captureStacks(0);
+}
+
+BOOST_AUTO_TEST_CASE(TestAllocationHooks)
+{
+  BOOST_REQUIRE(mc_rtc::alloc::available());
+  mc_rtc::alloc::reset();
+  {
+    mc_rtc::alloc::Scope scope("hooks");
+    void * ptr = nullptr;
+    // Every glibc allocation entry point is observed
+    do_free(calloc(4, 16));
+    ptr = realloc(nullptr, 16);
+    ptr = reallocarray(ptr, 4, 16);
+    do_free(ptr);
+    do_free(memalign(64, 16));
+    do_free(aligned_alloc(64, 64));
+    BOOST_REQUIRE_EQUAL(posix_memalign(&ptr, 64, 16), 0);
+    do_free(ptr);
+    do_free(valloc(16));
+    do_free(pvalloc(16));
+  }
+  auto stats = mc_rtc::alloc::statistics();
+  auto hooks = findStage(stats, "hooks");
+  BOOST_REQUIRE(hooks);
+  BOOST_CHECK_EQUAL(hooks->allocations, 8);
+  BOOST_CHECK_EQUAL(hooks->deallocations, 7);
+}
@@ -1227,6 +1227,43 @@ BOOST_AUTO_TEST_CASE(TestConfigurartionRemove)
   BOOST_CHECK(!config.has("dict"));
 }
 
+BOOST_AUTO_TEST_CASE(TestConfigurationScratchData)
+{
+  std::string large(10000, 'a');
+  std::string request = R"({"category": ["Tasks", "CoM"], "name": "target", "large": ")" + large
+                        + R"(", "data": {"target": [0.0, 0.1, 0.8], "active": true}})";
+  // The second iteration re-uses the buffer grown by the first one
+  for(size_t i = 0; i < 2; ++i)
+  {
+    mc_rtc::Configuration::ScratchData scratch(request.c_str());
+    BOOST_REQUIRE(scratch.valid());
+    std::vector<std::string> category;
+    BOOST_REQUIRE(scratch.read("category", category));
+    BOOST_REQUIRE(category == std::vector<std::string>({"Tasks", "CoM"}));
+    std::string name;
+    BOOST_REQUIRE(scratch.read("name", name));
+    BOOST_REQUIRE(name == "target");
+    BOOST_REQUIRE(scratch.read("large", name));
+    BOOST_REQUIRE(name == large);
+    BOOST_REQUIRE(!scratch.read("data", name));
+    BOOST_REQUIRE(!scratch.read("name", category));
+    BOOST_REQUIRE(!scratch.read("none", name));
+    {
+      mc_rtc::Configuration::ScratchData nested(R"({"name": "nested"})");
+      BOOST_REQUIRE(nested.read("name", name));
+      BOOST_REQUIRE(name == "nested");
+    }
+    auto data = scratch.copy("data");
+    BOOST_REQUIRE(data("active") == true);
+    Eigen::Vector3d target = data("target");
+    BOOST_REQUIRE(target.isApprox(Eigen::Vector3d(0.0, 0.1, 0.8)));
+    BOOST_REQUIRE(scratch.copy("none").empty());
+  }
+  mc_rtc::Configuration::ScratchData invalid("{");
+  BOOST_REQUIRE(!invalid.valid());
+  BOOST_REQUIRE(invalid.copy("data").empty());
+}
+
 static std::string YAML_DATA3 = R"(
 v3d: [1.0, 2.0, 3.0]
 v3dPair:
@@ -1392,6 +1429,67 @@ BOOST_AUTO_TEST_CASE(TestFileConfiguration)
   bfs::remove(file);
 }
 
+BOOST_AUTO_TEST_CASE(TestConfigurationCache)
+{
+  auto file = sampleConfig(true, false);
+  auto reference = mc_rtc::Configuration(file).dump();
+  auto directory = getTmpFile();
+  mc_rtc::Configuration::cacheDirectory(directory);
+  BOOST_REQUIRE_EQUAL(mc_rtc::Configuration::cacheDirectory(), directory);
+  {
+    // Parse the file and fill the cache
+    mc_rtc::Configuration config(file);
+    BOOST_REQUIRE_EQUAL(config.dump(), reference);
+    BOOST_REQUIRE_EQUAL(std::distance(bfs::directory_iterator(directory), bfs::directory_iterator()), 1);
+  }
+  {
+    // Load from the cache
+    mc_rtc::Configuration config(file);
+    BOOST_REQUIRE_EQUAL(config.dump(), reference);
+  }
+  {
+    // Modifying the file invalidates the cache
+    std::ofstream ofs(file);
+    ofs << YAML_DATA2;
+  }
+  {
+    mc_rtc::Configuration config(file);
+    BOOST_REQUIRE(config.has("int"));
+    BOOST_REQUIRE(!config.has("double"));
+    BOOST_REQUIRE_EQUAL(static_cast<int>(config("int")), 12);
+  }
+  {
+    // Modifications that keep the size of the file are detected as well
+    std::ofstream ofs(file);
+    ofs << "int: 21";
+  }
+  {
+    mc_rtc::Configuration config(file);
+    BOOST_REQUIRE_EQUAL(static_cast<int>(config("int")), 21);
+    std::ofstream ofs(file);
+    ofs << "int: 34";
+  }
+  {
+    mc_rtc::Configuration config(file);
+    BOOST_REQUIRE_EQUAL(static_cast<int>(config("int")), 34);
+  }
+  {
+    // Documents that are not a map are cached too
+    std::ofstream ofs(file);
+    ofs << "[1, 2, 3]";
+  }
+  for(size_t i = 0; i < 2; ++i)
+  {
+    mc_rtc::Configuration config(file);
+    BOOST_REQUIRE(config.isArray());
+    std::vector<int> data = config;
+    BOOST_REQUIRE(data == std::vector<int>({1, 2, 3}));
+  }
+  mc_rtc::Configuration::cacheDirectory("");
+  bfs::remove(file);
+  bfs::remove_all(directory);
+}
+
 /** We purposefully create a number-like class that would create an ambiguity without the numeric_limits specialization
  */
 struct MyNumber
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+#include <mc_control/ControllerClient.h>
+#include <mc_control/ControllerServer.h>
+
+#include <mc_rtc/gui/Label.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+/** In-process client that keeps the value of the labels */
+struct LabelsClient : public mc_control::ControllerClient
+{
+  LabelsClient(mc_control::ControllerServer & server, mc_rtc::gui::StateBuilder & gui) : ControllerClient(server, gui)
+  {
+  }
+
+  void category(const std::vector<std::string> &, const std::string &) override {}
+
+  void label(const mc_control::ElementId & id, const std::string & value) override
+  {
+    labels[id.name] = value;
+  }
+
+  std::map<std::string, std::string> labels;
+};
+
+/** Publish until the in-process client sees the expected value */
+bool wait_for(mc_control::ControllerServer & server,
+              mc_rtc::gui::StateBuilder & gui,
+              LabelsClient & client,
+              const std::string & expected)
+{
+  std::vector<char> buffer;
+  auto t_last_received = std::chrono::system_clock::now();
+  for(size_t i = 0; i < 1000; ++i)
+  {
+    server.publish(gui);
+    client.run(buffer, t_last_received);
+    if(client.labels["value"] == expected)
+    {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+BOOST_AUTO_TEST_CASE(TestInProcessClient)
+{
+  for(bool async : {false, true})
+  {
+    for(bool delta : {false, true})
+    {
+      BOOST_TEST_MESSAGE("async: " << async << ", delta: " << delta);
+      std::string value = "initial";
+      mc_rtc::gui::StateBuilder gui;
+      gui.addElement({"Test"}, mc_rtc::gui::Label("value", [&value]() { return value; }));
+      mc_control::ControllerServer server(0.005, 0.01, {}, {});
+      server.delta(delta, 0.05);
+      server.async(async);
+      LabelsClient client(server, gui);
+      BOOST_REQUIRE(wait_for(server, gui, client, "initial"));
+      value = "updated";
+      BOOST_REQUIRE(wait_for(server, gui, client, "updated"));
+      server.async(false);
+    }
+  }
+}
@@ -27,6 +27,9 @@ BOOST_AUTO_TEST_CASE(TestGUIStateBuilder)
   auto ref_size = builder.update(buffer);
   {
     BOOST_REQUIRE(ref_size != empty_size);
+    // Clients that do not support partial states can read this message
+    auto state = mc_rtc::Configuration::fromMessagePack(buffer.data(), ref_size);
+    BOOST_REQUIRE(static_cast<int>(state[0]) == mc_rtc::gui::StateBuilder::PROTOCOL_VERSION);
   }
   builder.removeElement({"dummy", "provider"}, "value");
   builder.removeElement({"dummy", "provider"}, "point");
@@ -111,3 +114,79 @@ BOOST_AUTO_TEST_CASE(TestGUIStateBuilder)
     BOOST_REQUIRE(s == empty_size);
   }
 }
+
+BOOST_AUTO_TEST_CASE(TestGUIDelta)
+{
+  DummyProvider provider;
+  mc_rtc::gui::StateBuilder builder;
+  std::vector<char> buffer;
+  auto update = [&](bool full = false) {
+    auto s = builder.updateDelta(buffer, full);
+    return mc_rtc::Configuration::fromMessagePack(buffer.data(), s);
+  };
+  builder.addElement({"dummy"}, mc_rtc::gui::Label("value", [&provider] { return provider.value; }));
+  builder.addElement({"dummy", "provider"}, mc_rtc::gui::ArrayLabel("point", [&provider] { return provider.point; }));
+  // The first message is a full state
+  auto state = update();
+  BOOST_REQUIRE(state.size() == 5);
+  BOOST_REQUIRE(static_cast<int>(state[0]) == mc_rtc::gui::StateBuilder::DELTA_PROTOCOL_VERSION);
+  uint64_t id = state[4];
+  // Nothing changed
+  state = update();
+  BOOST_REQUIRE(state.size() == 6);
+  BOOST_REQUIRE(static_cast<int>(state[0]) == mc_rtc::gui::StateBuilder::DELTA_PROTOCOL_VERSION);
+  BOOST_REQUIRE(static_cast<uint64_t>(state[4]) == id);
+  BOOST_REQUIRE(state[5].size() == 0);
+  // Only the label changed
+  provider.value = 0.0;
+  state = update();
+  BOOST_REQUIRE(state.size() == 6);
+  BOOST_REQUIRE(state[5].size() == 1);
+  BOOST_REQUIRE(static_cast<uint64_t>(state[5][0][0]) == 0);
+  // Changes are relative to the last full state
+  provider.point.x() = 1.0;
+  state = update();
+  BOOST_REQUIRE(state[5].size() == 2);
+  BOOST_REQUIRE(static_cast<uint64_t>(state[5][1][0]) == 1);
+  // Adding an element forces a full state
+  builder.addElement({"dummy"}, mc_rtc::gui::Label("other", [&provider] { return provider.value; }));
+  state = update();
+  BOOST_REQUIRE(state.size() == 5);
+  BOOST_REQUIRE(static_cast<uint64_t>(state[4]) != id);
+  id = state[4];
+  state = update();
+  BOOST_REQUIRE(state.size() == 6);
+  BOOST_REQUIRE(state[5].size() == 0);
+  // Request a full state
+  state = update(true);
+  BOOST_REQUIRE(state.size() == 5);
+  BOOST_REQUIRE(static_cast<uint64_t>(state[4]) != id);
+}
+
+BOOST_AUTO_TEST_CASE(TestGUISnapshot)
+{
+  DummyProvider provider;
+  mc_rtc::gui::StateBuilder builder;
+  builder.addElement({"dummy"}, mc_rtc::gui::Label("value", [&provider] { return provider.value; }));
+  builder.addElement({"dummy", "provider"}, mc_rtc::gui::ArrayLabel("point", [&provider] { return provider.point; }));
+  builder.addElement({"other"}, mc_rtc::gui::Label("value", [&provider] { return provider.value; }));
+  std::vector<char> ref;
+  std::vector<char> buffer;
+  mc_rtc::gui::StateBuilder::Snapshot snapshot;
+  mc_rtc::gui::StateBuilder::Encoder encoder;
+  auto check = [&]() {
+    auto ref_size = builder.update(ref);
+    builder.capture(snapshot);
+    auto size = encoder.update(snapshot, buffer);
+    BOOST_REQUIRE(size == ref_size);
+    BOOST_REQUIRE(std::equal(ref.begin(), ref.begin() + static_cast<std::ptrdiff_t>(size), buffer.begin()));
+  };
+  check();
+  provider.value = 0.0;
+  check();
+  // The snapshot is re-used when the GUI shrinks
+  builder.removeCategory({"dummy"});
+  check();
+  builder.data().add("robots", std::vector<std::string>{"robot"});
+  check();
+}
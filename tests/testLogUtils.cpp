@@ -3,6 +3,7 @@
 #include <boost/filesystem.hpp>
 namespace bfs = boost::filesystem;
 
+#include <mc_rtc/log/BinaryLogReader.h>
 #include <mc_rtc/log/FlatLog.h>
 #include <mc_rtc/log/Logger.h>
 
@@ -57,13 +58,15 @@ std::string make_log_ref()
   using Policy = mc_rtc::Logger::Policy;
   mc_rtc::Logger logger(Policy::NON_THREADED, bfs::temp_directory_path().string(), "mc-rtc-test");
   logger.start("log-utils", 0.001);
+  LogData data;
   auto log_s = [&](size_t sec) {
     for(size_t i = 0; i < sec * 1000; ++i)
     {
+      // Unchanged values are not stored, the data changes so that the log can be split
+      data.refresh();
       logger.log();
     }
   };
-  LogData data;
   data.addToLogger(logger);
   /** Log for 10 seconds */
   log_s(10);
@@ -89,6 +92,8 @@ void do_cleanup(const std::string & path)
   {
     bfs::remove(path);
   }
+  // Logs written by the logger are indexed
+  bfs::remove(mc_rtc::log::BinaryLogReader::index_path(path));
 }
 
 bool check_split(const std::string & path)
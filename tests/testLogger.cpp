@@ -4,6 +4,8 @@
 
 #define EIGEN_RUNTIME_NO_MALLOC
 
+#include <mc_rtc/AllocationTracker.h>
+#include <mc_rtc/log/BinaryLogReader.h>
 #include <mc_rtc/log/FlatLog.h>
 #include <mc_rtc/log/Logger.h>
 
@@ -12,6 +14,7 @@ namespace bfs = boost::filesystem;
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
 #include <thread>
 
 #include "utils.h"
@@ -21,6 +24,13 @@ bool operator==(const Eigen::Quaterniond & lhs, const Eigen::Quaterniond & rhs)
   return lhs.vec() == rhs.vec();
 }
 
+/** Remove a log written by the logger and its index */
+void remove_log(const std::string & path)
+{
+  bfs::remove(path);
+  bfs::remove(mc_rtc::log::BinaryLogReader::index_path(path));
+}
+
 /** Check one iteration of the logger */
 template<bool malloc_allowed = false, typename Callback>
 void check(mc_rtc::Logger & logger, Callback && cb)
@@ -488,7 +498,7 @@ BOOST_AUTO_TEST_CASE(TestLogger)
   }
   if(bfs::exists(path))
   {
-    bfs::remove(path);
+    remove_log(path);
   }
 }
 
@@ -537,6 +547,350 @@ BOOST_AUTO_TEST_CASE(TestResume)
     auto first_t2 = flat_2.get<double>("t", 0, 0.0);
     BOOST_REQUIRE(std::fabs(first_t2 - final_t1 - dt) < 1e-9);
   }
-  bfs::remove(path_1);
-  bfs::remove(path_2);
+  remove_log(path_1);
+  remove_log(path_2);
+}
+
+BOOST_AUTO_TEST_CASE(TestThreadedLogger)
+{
+  std::string path;
+  size_t n_iter = 5000;
+  uint64_t dropped = 0;
+  {
+    using Policy = mc_rtc::Logger::Policy;
+    mc_rtc::Logger logger(Policy::THREADED, bfs::temp_directory_path().string(), "mc-rtc-test");
+    logger.start("threaded-logger", 0.001);
+    path = logger.path();
+    size_t iter = 0;
+    logger.addLogEntry("iter", [&iter]() { return static_cast<uint64_t>(iter); });
+    LogData data;
+    data.addToLoggerWithMemberPointer(logger);
+    /** Once the frames of the ring have been used, logging does not allocate on the calling thread */
+    size_t warmup = n_iter / 2;
+    for(iter = 0; iter < warmup; ++iter)
+    {
+      logger.log();
+    }
+    mc_rtc::alloc::reset();
+    for(; iter < n_iter; ++iter)
+    {
+      mc_rtc::alloc::Scope scope("Logger::log");
+      logger.log();
+    }
+    if(mc_rtc::alloc::available())
+    {
+      mc_rtc::alloc::report();
+      BOOST_REQUIRE_EQUAL(mc_rtc::alloc::allocations(), 0);
+    }
+    auto stats = logger.statistics();
+    BOOST_REQUIRE(stats.capacity > 0);
+    BOOST_REQUIRE(stats.high_water_mark <= stats.capacity);
+    dropped = stats.dropped;
+  }
+  auto latest = bfs::temp_directory_path() / "mc-rtc-test-threaded-logger-latest.bin";
+  if(bfs::exists(latest))
+  {
+    bfs::remove(latest);
+  }
+  {
+    mc_rtc::log::FlatLog log(path);
+    /** Frames are either written in order or dropped */
+    BOOST_REQUIRE(log.size() + dropped == n_iter);
+    auto iters = log.get<uint64_t>("iter");
+    for(size_t i = 1; i < iters.size(); ++i)
+    {
+      BOOST_REQUIRE(iters[i] > iters[i - 1]);
+    }
+    /** Columns are contiguous and share the same storage as get */
+    auto span = log.getSpan<uint64_t>("iter");
+    BOOST_REQUIRE(span.size() == iters.size());
+    for(size_t i = 0; i < span.size(); ++i)
+    {
+      BOOST_REQUIRE(span[i] == iters[i]);
+      BOOST_REQUIRE(&span[i] == log.getRaw<uint64_t>("iter", i));
+    }
+    BOOST_REQUIRE(log.getSpan<uint64_t>("not-a-key").empty());
+  }
+  remove_log(path);
+}
+
+BOOST_AUTO_TEST_CASE(TestSnapshotLogger)
+{
+  std::string path;
+  LogData data;
+  LogData removed;
+  auto wait_writer = []() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
+  {
+    using Policy = mc_rtc::Logger::Policy;
+    mc_rtc::Logger logger(Policy::SNAPSHOT, bfs::temp_directory_path().string(), "mc-rtc-test");
+    logger.start("snapshot-logger", 0.001);
+    path = logger.path();
+    /** Iterations 0 to 99, entries with a source */
+    data.addToLogger(logger, true);
+    for(size_t i = 0; i < 100; ++i)
+    {
+      logger.log();
+      wait_writer();
+    }
+    /** Iterations 100 to 109, no entries */
+    logger.removeLogEntries(&data);
+    for(size_t i = 0; i < 10; ++i)
+    {
+      logger.log();
+      wait_writer();
+    }
+    /** Iterations 110 to 209, entries from getters with new data */
+    removed = data;
+    data.refresh();
+    data.addToLoggerWithGetter(logger);
+    for(size_t i = 0; i < 100; ++i)
+    {
+      /** The snapshot copy does not allocate once every snapshot has been used */
+      Eigen::internal::set_is_malloc_allowed(i < 64);
+      logger.log();
+      Eigen::internal::set_is_malloc_allowed(true);
+      wait_writer();
+    }
+    BOOST_REQUIRE(logger.statistics().dropped == 0);
+  }
+  auto latest = bfs::temp_directory_path() / "mc-rtc-test-snapshot-logger-latest.bin";
+  if(bfs::exists(latest))
+  {
+    bfs::remove(latest);
+  }
+  {
+    mc_rtc::log::FlatLog log(path);
+    BOOST_REQUIRE(log.size() == 210);
+    auto t0 = log.getRaw<double>("t", 0);
+    BOOST_REQUIRE(t0 && *t0 == 0.0);
+    removed.check_empty(log, 105);
+    data.check(log);
+  }
+  remove_log(path);
+}
+
+BOOST_AUTO_TEST_CASE(TestUnchangedValues)
+{
+  using Policy = mc_rtc::Logger::Policy;
+  size_t n_iter = 2 * mc_rtc::Logger::keyframe_period + 10;
+  for(auto policy : {Policy::NON_THREADED, Policy::SNAPSHOT})
+  {
+    std::string path;
+    LogData data;
+    std::vector<double> large(256, 42.0);
+    uint64_t dropped = 0;
+    {
+      mc_rtc::Logger logger(policy, bfs::temp_directory_path().string(), "mc-rtc-test");
+      logger.start("unchanged-logger", 0.001);
+      path = logger.path();
+      size_t iter = 0;
+      /** Changes every iteration */
+      logger.addLogEntry("iter", [&iter]() { return static_cast<uint64_t>(iter); });
+      /** Changes every 100 iterations */
+      logger.addLogEntry("slow", [&iter]() -> Eigen::Vector3d {
+        return Eigen::Vector3d::Constant(static_cast<double>(iter / 100));
+      });
+      /** Never changes */
+      data.addToLogger(logger, true);
+      /** Never changes and is larger than everything else */
+      logger.addLogEntry("large", [&large]() -> const std::vector<double> & { return large; });
+      for(iter = 0; iter < n_iter; ++iter)
+      {
+        logger.log();
+        if(policy == Policy::SNAPSHOT && iter % 32 == 0)
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+      dropped = logger.statistics().dropped;
+    }
+    auto latest = bfs::temp_directory_path() / "mc-rtc-test-unchanged-logger-latest.bin";
+    if(bfs::exists(latest))
+    {
+      bfs::remove(latest);
+    }
+    // The large entry is only stored in the keyframes
+    BOOST_REQUIRE(bfs::file_size(path) < n_iter * large.size());
+    {
+      mc_rtc::log::FlatLog log(path);
+      BOOST_REQUIRE(log.size() + dropped == n_iter);
+      data.check(log);
+      BOOST_REQUIRE(*log.getRaw<std::vector<double>>("large", log.size() - 1) == large);
+      for(size_t i = 0; i < log.size(); ++i)
+      {
+        auto iter = log.getRaw<uint64_t>("iter", i);
+        BOOST_REQUIRE(iter);
+        ::check(log, "slow", i, Eigen::Vector3d(Eigen::Vector3d::Constant(static_cast<double>(*iter / 100))));
+        ::check(log, "Eigen::VectorXd", i, *log.getRaw<Eigen::VectorXd>("Eigen::VectorXd", 0));
+        ::check(log, "sva::PTransformd", i, *log.getRaw<sva::PTransformd>("sva::PTransformd", 0));
+      }
+    }
+    remove_log(path);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestBinaryLogReader)
+{
+  using Policy = mc_rtc::Logger::Policy;
+  size_t n_iter = 3 * mc_rtc::Logger::keyframe_period + 500;
+  auto path = (bfs::temp_directory_path() / "mc-rtc-test-reader.bin").string();
+  {
+    mc_rtc::Logger logger(Policy::NON_THREADED, "", "");
+    logger.open(path, 0.001);
+    size_t iter = 0;
+    logger.addLogEntry("iter", [&iter]() { return static_cast<uint64_t>(iter); });
+    LogData data;
+    data.addToLogger(logger, true);
+    for(iter = 0; iter < n_iter; ++iter)
+    {
+      logger.log();
+    }
+  }
+  auto index = mc_rtc::log::BinaryLogReader::index_path(path);
+  BOOST_REQUIRE(bfs::exists(index));
+  /** Returns the iteration of the next frame */
+  auto next_iter = [](mc_rtc::log::BinaryLogReader & reader) {
+    uint64_t out = 0;
+    reader.iterate(
+        [&](const std::vector<std::string> & keys, std::vector<mc_rtc::log::FlatLog::record> & records, double) {
+          auto it = std::find(keys.begin(), keys.end(), "iter");
+          BOOST_REQUIRE(it != keys.end());
+          auto & r = records[static_cast<size_t>(std::distance(keys.begin(), it))];
+          BOOST_REQUIRE(r.type == mc_rtc::log::LogType::Uint64_t);
+          out = *static_cast<const uint64_t *>(r.data.get());
+          return false;
+        },
+        true);
+    return out;
+  };
+  auto check_reader = [&]() {
+    mc_rtc::log::BinaryLogReader reader(path);
+    BOOST_REQUIRE(reader.valid());
+    BOOST_REQUIRE(reader.size() == n_iter);
+    BOOST_REQUIRE(reader.seekIteration(2999));
+    BOOST_REQUIRE(reader.iteration() == 2999);
+    BOOST_REQUIRE(next_iter(reader) == 2999);
+    BOOST_REQUIRE(reader.seekIteration(12));
+    BOOST_REQUIRE(next_iter(reader) == 12);
+    BOOST_REQUIRE(reader.seek(1.5005));
+    BOOST_REQUIRE(next_iter(reader) == 1501);
+    BOOST_REQUIRE(!reader.seekIteration(n_iter));
+    BOOST_REQUIRE(!reader.seek(static_cast<double>(n_iter)));
+  };
+  check_reader();
+  /** The index is rebuilt if it is missing */
+  bfs::remove(index);
+  check_reader();
+  {
+    mc_rtc::log::FlatLog log;
+    log.load(path, 1.0005, 2.0005);
+    BOOST_REQUIRE(log.size() == 1000);
+    BOOST_REQUIRE(log.get<uint64_t>("iter", 0, 0) == 1001);
+    BOOST_REQUIRE(log.get<uint64_t>("iter", 999, 0) == 2000);
+  }
+  remove_log(path);
+}
+
+BOOST_AUTO_TEST_CASE(TestLazyFlatLog)
+{
+  using Policy = mc_rtc::Logger::Policy;
+  size_t n_iter = 2 * mc_rtc::Logger::keyframe_period + 500;
+  auto path = (bfs::temp_directory_path() / "mc-rtc-test-lazy.bin").string();
+  LogData data;
+  {
+    mc_rtc::Logger logger(Policy::NON_THREADED, "", "");
+    logger.open(path, 0.001);
+    size_t iter = 0;
+    logger.addLogEntry("iter", [&iter]() { return static_cast<uint64_t>(iter); });
+    logger.addLogEntry("slow", [&iter]() -> Eigen::Vector3d {
+      return Eigen::Vector3d::Constant(static_cast<double>(iter / 100));
+    });
+    data.addToLogger(logger, true);
+    for(iter = 0; iter < n_iter; ++iter)
+    {
+      /** An entry that changes type over time */
+      if(iter == 500)
+      {
+        logger.addLogEntry("changing", [&iter]() { return static_cast<double>(iter); });
+      }
+      if(iter == 1500)
+      {
+        logger.removeLogEntry("changing");
+        logger.addLogEntry("changing", [&iter]() { return std::to_string(iter); });
+      }
+      logger.log();
+    }
+  }
+  mc_rtc::log::FlatLog eager(path);
+  mc_rtc::log::FlatLog lazy(path, true);
+  BOOST_REQUIRE(lazy.size() == n_iter);
+  BOOST_REQUIRE(lazy.entries() == eager.entries());
+  data.check(lazy);
+  auto check_entry = [&](const std::string & entry, auto tag) {
+    using T = decltype(tag);
+    BOOST_REQUIRE(lazy.types(entry) == eager.types(entry));
+    for(size_t i = 0; i < n_iter; ++i)
+    {
+      BOOST_REQUIRE(lazy.type(entry, i) == eager.type(entry, i));
+      auto l = lazy.getRaw<T>(entry, i);
+      auto e = eager.getRaw<T>(entry, i);
+      BOOST_REQUIRE(static_cast<bool>(l) == static_cast<bool>(e));
+      if(l)
+      {
+        BOOST_REQUIRE(*l == *e);
+      }
+    }
+  };
+  check_entry("iter", uint64_t{});
+  check_entry("slow", Eigen::Vector3d{});
+  check_entry("changing", double{});
+  check_entry("changing", std::string{});
+  BOOST_REQUIRE(lazy.get<double>("changing", 499, -1.0) == -1.0);
+  BOOST_REQUIRE(lazy.get<double>("changing", 1499, -1.0) == 1499.0);
+  BOOST_REQUIRE(lazy.get<std::string>("changing", 1500, "") == "1500");
+  /** Entries of a lazy log can be decoded concurrently through the const accessors */
+  {
+    const mc_rtc::log::FlatLog concurrent(path, true);
+    std::atomic<size_t> errors{0};
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < 4; ++t)
+    {
+      threads.emplace_back([&]() {
+        for(size_t i = 0; i < n_iter; ++i)
+        {
+          if(concurrent.get<uint64_t>("iter", i, 0) != i
+             || concurrent.get<Eigen::Vector3d>("slow", i, {}) != *eager.getRaw<Eigen::Vector3d>("slow", i))
+          {
+            errors++;
+          }
+        }
+      });
+    }
+    for(auto & th : threads)
+    {
+      th.join();
+    }
+    BOOST_REQUIRE(errors == 0);
+  }
+  /** Decoding the whole log on several threads gives the same result */
+  for(size_t jobs : {1, 4, 64})
+  {
+    mc_rtc::log::FlatLog parallel(path, true);
+    /** Already decoded entries are kept */
+    BOOST_REQUIRE(parallel.get<uint64_t>("iter", 42, 0) == 42);
+    parallel.decodeAll(jobs);
+    std::swap(lazy, parallel);
+    data.check(lazy);
+    check_entry("iter", uint64_t{});
+    check_entry("slow", Eigen::Vector3d{});
+    check_entry("changing", double{});
+    check_entry("changing", std::string{});
+    std::swap(lazy, parallel);
+  }
+  /** Appending to a lazy log decodes it first */
+  lazy.append(path);
+  BOOST_REQUIRE(lazy.size() == 2 * n_iter);
+  BOOST_REQUIRE(lazy.get<uint64_t>("iter", n_iter + 12, 0) == 12);
+  BOOST_REQUIRE(lazy.get<uint64_t>("iter", 12, 0) == 12);
+  remove_log(path);
 }
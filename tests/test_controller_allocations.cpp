@@ -0,0 +1,92 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+/** Check that a controller does not allocate memory in MCGlobalController::run once it is warmed up
+ *
+ * Usage: test_controller_allocations -- [conf] [warm-up iterations] [checked iterations]
+ *
+ * The configuration must enable the log and the GUI server so that they are checked as well
+ *
+ * This must be linked to mc_rtc_alloc_hooks
+ */
+
+#include <mc_control/mc_global_controller.h>
+
+#include <mc_rtc/AllocationTracker.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdlib.h>
+
+#include "utils.h"
+
+static bool initialized = configureRobotLoader();
+
+BOOST_AUTO_TEST_CASE(NO_ALLOCATIONS)
+{
+  auto argc = boost::unit_test::framework::master_test_suite().argc;
+  auto argv = boost::unit_test::framework::master_test_suite().argv;
+  // In older versions of Boost, -- is not filtered out from argv
+  int argi = 1;
+  if(argc > 1 && std::string(argv[1]) == "--")
+  {
+    argi = 2;
+  }
+  BOOST_REQUIRE(argc >= argi + 3);
+  BOOST_REQUIRE(mc_rtc::alloc::available());
+  std::string conf = argv[argi];
+  unsigned int warmup = static_cast<unsigned int>(std::atoi(argv[argi + 1]));
+  unsigned int nrIter = static_cast<unsigned int>(std::atoi(argv[argi + 2]));
+  BOOST_REQUIRE(nrIter > 0);
+
+  mc_control::MCGlobalController controller(conf);
+  BOOST_REQUIRE(controller.configuration().enable_log);
+  BOOST_REQUIRE(controller.configuration().enable_gui_server);
+  const auto & mb = controller.robot().mb();
+  const auto & mbc = controller.robot().mbc();
+  std::vector<double> initq;
+  for(const auto & jn : controller.ref_joint_order())
+  {
+    for(const auto & qi : mbc.q[static_cast<unsigned int>(mb.jointIndexByName(jn))])
+    {
+      initq.push_back(qi);
+    }
+  }
+  // Sensor buffers are allocated once, the interface is not under test
+  std::vector<double> qEnc(initq.size(), 0);
+  std::vector<double> alphaEnc(initq.size(), 0);
+  auto simulateSensors = [&]() {
+    auto & robot = controller.robot();
+    for(unsigned i = 0; i < robot.refJointOrder().size(); i++)
+    {
+      auto jIdx = robot.jointIndexInMBC(i);
+      if(jIdx != -1)
+      {
+        auto jointIndex = static_cast<unsigned>(jIdx);
+        qEnc[i] = robot.mbc().q[jointIndex][0];
+        alphaEnc[i] = robot.mbc().alpha[jointIndex][0];
+      }
+    }
+    controller.setEncoderValues(qEnc);
+    controller.setEncoderVelocities(alphaEnc);
+  };
+
+  controller.setEncoderValues(qEnc);
+  controller.init(initq, controller.robot().module().default_attitude());
+  controller.running = true;
+  auto run = [&](unsigned int nIter) {
+    for(unsigned int i = 0; i < nIter; ++i)
+    {
+      simulateSensors();
+      BOOST_REQUIRE(controller.run());
+    }
+  };
+  run(warmup);
+  mc_rtc::alloc::captureStacks(16);
+  mc_rtc::alloc::reset();
+  run(nrIter);
+  auto allocations = mc_rtc::alloc::allocations();
+  mc_rtc::alloc::report();
+  BOOST_CHECK_EQUAL(allocations, 0);
+}
@@ -66,6 +66,7 @@ BOOST_AUTO_TEST_CASE(RUN)
 
   std::vector<double> qEnc(initq.size(), 0);
   std::vector<double> alphaEnc(initq.size(), 0);
+  auto handles = controller.sensorHandles(controller.robot().name(), {"FloatingBase"}, {}, {});
   auto simulateSensors = [&, qEnc, alphaEnc]() mutable {
     auto & robot = controller.robot();
     for(unsigned i = 0; i < robot.refJointOrder().size(); i++)
@@ -82,6 +83,10 @@ BOOST_AUTO_TEST_CASE(RUN)
     controller.setEncoderVelocities(alphaEnc);
     controller.setSensorPositions({{"FloatingBase", robot.posW().translation()}});
     controller.setSensorOrientations({{"FloatingBase", Eigen::Quaterniond{robot.posW().rotation()}}});
+    // Handles must follow controller changes
+    controller.resolve(handles);
+    BOOST_REQUIRE(&handles.bodySensor(0) == &controller.robot().bodySensor("FloatingBase"));
+    handles.bodySensor(0).linearVelocity(Eigen::Vector3d::Zero());
   };
 
   controller.setEncoderValues(qEnc);
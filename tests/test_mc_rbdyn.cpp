@@ -1,6 +1,9 @@
 #include <mc_rbdyn/RobotLoader.h>
 #include <mc_rbdyn/Robots.h>
+#include <mc_rbdyn/SCHAddon.h>
 #include <mc_rbdyn/rpy_utils.h>
+#include <RBDyn/CoM.h>
+#include <RBDyn/FK.h>
 #include <boost/test/unit_test.hpp>
 #include "utils.h"
 #include <chrono>
@@ -58,6 +61,13 @@ void TestRobotLoadingCommon(mc_rbdyn::RobotModulePtr rm, mc_rbdyn::RobotModulePt
   BOOST_REQUIRE_EQUAL(robotCopy.robotIndex(), 2);
   BOOST_REQUIRE_EQUAL(robotCopy.name(), "robotCopy");
   auto & robot = robots_ptr->robot("renamed");
+  // The module is shared by the copies
+  BOOST_REQUIRE(&robotCopy.module() == &robot.module());
+  {
+    auto robots_copy = mc_rbdyn::Robots::make();
+    robots_ptr->copy(*robots_copy);
+    BOOST_REQUIRE(&robots_copy->robot("renamed").module() == &robot.module());
+  }
   for(const auto & c : robot.convexes())
   {
     BOOST_REQUIRE(robotCopy.hasConvex(c.first));
@@ -134,6 +144,61 @@ BOOST_AUTO_TEST_CASE(TestRobotPosWVelWAccW)
   }
 }
 
+BOOST_AUTO_TEST_CASE(TestRobotCoMCache)
+{
+  auto & robots = get_robots();
+  auto & robot = robots.robot();
+  const auto & crobot = robot;
+  auto checkCoM = [&]() {
+    BOOST_REQUIRE(crobot.com().isApprox(rbd::computeCoM(crobot.mb(), crobot.mbc())));
+    BOOST_REQUIRE(crobot.comVelocity().isApprox(rbd::computeCoMVelocity(crobot.mb(), crobot.mbc())));
+  };
+  for(int i = 0; i < 10; ++i)
+  {
+    robot.posW(sva::PTransformd(mc_rbdyn::rpyToMat(Eigen::Vector3d::Random()), Eigen::Vector3d::Random()));
+    checkCoM();
+    robot.velW(sva::MotionVecd{Eigen::Vector3d::Random(), Eigen::Vector3d::Random()});
+    checkCoM();
+    // Modify the configuration through a reference then update the kinematics
+    auto & q = robot.q();
+    q[0][4] += 1.0;
+    robot.forwardKinematics();
+    checkCoM();
+    // Modify the configuration outside of the robot then notify it
+    robots.mbcs()[0].q[0][5] += 1.0;
+    rbd::forwardKinematics(robot.mb(), robots.mbcs()[0]);
+    robot.invalidateKinematicsCache();
+    checkCoM();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestRobotFrameCache)
+{
+  auto & robots = get_robots();
+  auto & robot = robots.robot();
+  const auto & body = robot.mb().body(1).name();
+  sva::PTransformd X_b_p(Eigen::Vector3d(0.1, 0., 0.));
+  auto & parent =
+      robot.hasFrame("CacheParent") ? robot.frame("CacheParent") : robot.makeFrame("CacheParent", robot.frame(body), X_b_p);
+  auto & child = robot.hasFrame("CacheChild")
+                     ? robot.frame("CacheChild")
+                     : robot.makeFrame("CacheChild", parent, sva::PTransformd(Eigen::Vector3d(0., 0.1, 0.)));
+  auto expected = [&]() { return child.X_p_f() * parent.X_p_f() * robot.bodyPosW(body); };
+  for(int i = 0; i < 10; ++i)
+  {
+    robot.posW(sva::PTransformd(mc_rbdyn::rpyToMat(Eigen::Vector3d::Random()), Eigen::Vector3d::Random()));
+    BOOST_REQUIRE(child.position().matrix().isApprox(expected().matrix()));
+    // Modifying a parent frame updates its children
+    parent.X_p_f(sva::PTransformd(Eigen::Vector3d::Random()));
+    BOOST_REQUIRE(child.position().matrix().isApprox(expected().matrix()));
+    robot.velW(sva::MotionVecd{Eigen::Vector3d::Random(), Eigen::Vector3d::Random()});
+    auto vel = robot.bodyVelW(body);
+    auto X_0_b = robot.bodyPosW(body);
+    vel.linear() += -mc_rbdyn::hat(X_0_b.rotation().transpose() * parent.X_p_f().translation()) * vel.angular();
+    BOOST_REQUIRE(parent.velocity().vector().isApprox(vel.vector()));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestRobotZMPSimple)
 {
   auto & robots = get_robots();
@@ -194,3 +259,48 @@ BOOST_AUTO_TEST_CASE(TestRobotZMPSimple)
     BOOST_CHECK_THROW(robot.zmp(sensorNames, Eigen::Vector3d::Zero(), {0., 0., 1.}), std::runtime_error);
   }
 }
+
+BOOST_AUTO_TEST_CASE(TestPolyhedronCache)
+{
+  configureRobotLoader();
+  auto rm = mc_rbdyn::RobotLoader::get_robot_module("JVRC1");
+  BOOST_REQUIRE(rm->convexHull().size());
+  const auto & path = rm->convexHull().begin()->second.second;
+  auto check = [](sch::S_Polyhedron & lhs, sch::S_Polyhedron & rhs) {
+    const auto & lhsAlgo = *lhs.getPolyhedronAlgorithm();
+    const auto & rhsAlgo = *rhs.getPolyhedronAlgorithm();
+    BOOST_REQUIRE_EQUAL(lhsAlgo.vertexes_.size(), rhsAlgo.vertexes_.size());
+    BOOST_REQUIRE_EQUAL(lhsAlgo.triangles_.size(), rhsAlgo.triangles_.size());
+    for(size_t i = 0; i < lhsAlgo.vertexes_.size(); ++i)
+    {
+      const auto & lhsV = *lhsAlgo.vertexes_[i];
+      const auto & rhsV = *rhsAlgo.vertexes_[i];
+      BOOST_REQUIRE_EQUAL(lhsV.getNumNeighbors(), rhsV.getNumNeighbors());
+      for(int j = 0; j < 3; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(lhsV.getCoordinates()[j], rhsV.getCoordinates()[j]);
+      }
+    }
+  };
+  sch::mc_rbdyn::clearPolyhedronCache();
+  std::unique_ptr<sch::S_Polyhedron> ref(sch::mc_rbdyn::Polyhedron(path));
+  std::unique_ptr<sch::S_Polyhedron> copy(sch::mc_rbdyn::Polyhedron(path));
+  BOOST_REQUIRE(ref.get() != copy.get());
+  check(*ref, *copy);
+
+  // Store the polyhedron on disk then load it from there
+  auto directory = getTmpFile();
+  sch::mc_rbdyn::setPolyhedronCacheDirectory(directory);
+  sch::mc_rbdyn::clearPolyhedronCache();
+  std::unique_ptr<sch::S_Polyhedron> written(sch::mc_rbdyn::Polyhedron(path));
+  check(*ref, *written);
+  BOOST_REQUIRE_EQUAL(std::distance(bfs::directory_iterator(directory), bfs::directory_iterator()), 1);
+  sch::mc_rbdyn::clearPolyhedronCache();
+  std::unique_ptr<sch::S_Polyhedron> read(sch::mc_rbdyn::Polyhedron(path));
+  check(*ref, *read);
+  // Evicting a file also removes it from the disk
+  sch::mc_rbdyn::clearPolyhedronCache(path);
+  BOOST_REQUIRE(bfs::is_empty(directory));
+  sch::mc_rbdyn::setPolyhedronCacheDirectory("");
+  bfs::remove_all(directory);
+}
@@ -1,6 +1,15 @@
+#include <mc_rtc/Configuration.h>
+#include <mc_rtc/LatencyHistogram.h>
+#include <mc_rtc/Tracing.h>
+#include <mc_rtc/WorkerPool.h>
 #include <mc_rtc/constants.h>
 #include <boost/test/unit_test.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <thread>
+
 BOOST_AUTO_TEST_CASE(TestConstants)
 {
   namespace cst = mc_rtc::constants;
@@ -11,3 +20,100 @@ BOOST_AUTO_TEST_CASE(TestConstants)
 
   BOOST_REQUIRE(cst::GRAVITY > 0);
 }
+
+BOOST_AUTO_TEST_CASE(TestWorkerPool)
+{
+  // No spin: the workers and the caller always sleep, long spin: they (almost) never sleep
+  for(auto spin : {std::chrono::microseconds{0}, std::chrono::microseconds{50}, std::chrono::microseconds{1000}})
+  {
+    for(size_t threads : {0, 1, 3})
+    {
+      mc_rtc::WorkerPool pool(threads, {}, spin);
+      BOOST_REQUIRE(pool.size() == threads);
+      std::vector<size_t> out(1000, 0);
+      for(size_t iter = 1; iter < 100; ++iter)
+      {
+        pool.run(out.size(), [&](size_t i) { out[i] += i; });
+        for(size_t i = 0; i < out.size(); ++i)
+        {
+          BOOST_REQUIRE(out[i] == iter * i);
+        }
+      }
+      size_t calls = 0;
+      pool.run(0, [&](size_t) { calls++; });
+      pool.run(1, [&](size_t) { calls++; });
+      BOOST_REQUIRE(calls == 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestLatencyHistogram)
+{
+  mc_rtc::LatencyHistogram histogram(0.9, 100);
+  BOOST_REQUIRE(histogram.count() == 0);
+  BOOST_REQUIRE(histogram.percentile(50) == 0);
+  // 1000 samples from 0.001ms to 1ms
+  for(size_t i = 1; i <= 1000; ++i)
+  {
+    histogram.record(static_cast<double>(i) * 1e-3);
+  }
+  auto summary = histogram.summary();
+  BOOST_REQUIRE(summary.count == 1000);
+  BOOST_REQUIRE_CLOSE(summary.mean, 0.5005, 1e-6);
+  BOOST_REQUIRE_CLOSE(summary.p50, 0.5, 3.5);
+  BOOST_REQUIRE_CLOSE(summary.p99, 0.99, 3.5);
+  BOOST_REQUIRE_CLOSE(summary.p999, 0.999, 3.5);
+  BOOST_REQUIRE(summary.p999 <= summary.max);
+  BOOST_REQUIRE_CLOSE(summary.max, 1.0, 1e-6);
+  BOOST_REQUIRE(summary.deadline_misses == 100);
+  // The window holds the last 100 samples: 0.901ms to 1ms
+  BOOST_REQUIRE_CLOSE(summary.jitter, 0.0290115, 1e-3);
+  histogram.reset();
+  BOOST_REQUIRE(histogram.count() == 0);
+  BOOST_REQUIRE(histogram.max() == 0);
+  BOOST_REQUIRE(histogram.jitter() == 0);
+  // Durations below 32ns are exact
+  histogram.record(20e-6);
+  BOOST_REQUIRE_CLOSE(histogram.percentile(100), 20e-6, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(TestTracing)
+{
+  namespace trace = mc_rtc::trace;
+  auto spans = [](size_t ticks) {
+    for(size_t i = 0; i < ticks; ++i)
+    {
+      trace::tick();
+      trace::Span tick("tick");
+      trace::Span span("test", std::string("a \"quoted\" span name that is longer than the event name buffer"));
+    }
+  };
+  trace::threadName("main");
+  spans(10);
+  std::thread th([]() {
+    trace::threadName("worker");
+    trace::Span worker("worker");
+  });
+  th.join();
+  auto path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string() + ".json";
+  BOOST_REQUIRE(trace::dump(path, 2));
+  auto events = mc_rtc::Configuration(path)("traceEvents");
+  size_t ticks = 0;
+  size_t workers = 0;
+  for(size_t i = 0; i < events.size(); ++i)
+  {
+    std::string ph = events[i]("ph");
+    if(ph != "X")
+    {
+      continue;
+    }
+    std::string name = events[i]("name");
+    ticks += name == "tick";
+    workers += name == "worker";
+    BOOST_REQUIRE(static_cast<double>(events[i]("dur")) >= 0);
+  }
+  // The last two ticks (the worker ran after them)
+  BOOST_REQUIRE(ticks == 2);
+  BOOST_REQUIRE(workers == 1);
+  boost::filesystem::remove(path);
+}
@@ -175,7 +175,7 @@ int main(int argc, char * argv[])
   }
   PerfTable vt(std::array<PrettyColumn, 5>{PrettyColumn{""}, PrettyColumn{"Average"}, PrettyColumn{"StdEv"},
                                            PrettyColumn{"Min"}, PrettyColumn{"Max"}});
-  mc_rtc::log::FlatLog log(file);
+  mc_rtc::log::FlatLog log(file, true);
   auto range = getRange(log, key);
   auto keys = log.entries();
   for(const auto & k : keys)
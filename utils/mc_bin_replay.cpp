@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015-2023 CNRS-UM LIRMM, CNRS-AIST JRL
+ */
+
+/** Replay the sensor inputs recorded in a binary log through a controller as fast as possible and report the timing
+ * and determinism of the replay, see mc_control::replayLog */
+
+#include <mc_control/LogReplay.h>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <iostream>
+
+int main(int argc, char * argv[])
+{
+  po::variables_map vm;
+  po::options_description tool("mc_bin_replay options");
+  // clang-format off
+  tool.add_options()
+    ("help", "Produce this message")
+    ("in", po::value<std::string>(), "Binary log to replay")
+    ("conf,f", po::value<std::string>()->default_value(""), "mc_rtc configuration file")
+    ("controller,c", po::value<std::string>(), "Controller to run (default: initial controller of the configuration)")
+    ("warmup,w", po::value<size_t>()->default_value(100), "Number of ticks excluded from the timing statistics")
+    ("ticks,n", po::value<size_t>()->default_value(0), "Maximum number of ticks to replay (0: whole log)")
+    ("tolerance,t", po::value<double>()->default_value(1e-6), "Tolerance of the comparison with the log outputs")
+    ("out,o", po::value<std::string>(), "Write the report to this file (.json or .yaml) instead of the standard output")
+    ("log", "Keep the controller log enabled")
+    ("gui", "Keep the GUI server enabled")
+    ("check", "Exit with an error if the replayed outputs diverge from the log");
+  // clang-format on
+  po::positional_options_description pos;
+  pos.add("in", 1);
+  po::store(po::command_line_parser(argc, argv).options(tool).positional(pos).run(), vm);
+  po::notify(vm);
+
+  if(!vm.count("in") || vm.count("help"))
+  {
+    std::cout << "Usage: mc_bin_replay [options] [in]\n\n";
+    std::cout << tool << "\n";
+    return !vm.count("help");
+  }
+
+  mc_control::MCGlobalController::GlobalConfiguration gconf(vm["conf"].as<std::string>());
+  gconf.enable_log = vm.count("log") != 0;
+  gconf.enable_gui_server = vm.count("gui") != 0;
+  if(vm.count("controller"))
+  {
+    auto controller = vm["controller"].as<std::string>();
+    gconf.enabled_controllers = {controller};
+    gconf.initial_controller = controller;
+  }
+  mc_control::MCGlobalController controller(gconf);
+
+  mc_control::LogReplayOptions options;
+  options.warmup = vm["warmup"].as<size_t>();
+  options.max_ticks = vm["ticks"].as<size_t>();
+  options.tolerance = vm["tolerance"].as<double>();
+  auto report = mc_control::replayLog(controller, vm["in"].as<std::string>(), options);
+
+  auto out = report.save();
+  if(vm.count("out"))
+  {
+    out.save(vm["out"].as<std::string>());
+  }
+  else
+  {
+    std::cout << out.dump(true, true) << "\n";
+  }
+  if(!report.success)
+  {
+    return 1;
+  }
+  if(!report.deterministic())
+  {
+    mc_rtc::log::warning("Replay diverged from the log at tick {} (in {} ticks)", report.first_divergence,
+                         report.diverged_ticks);
+    return vm.count("check") ? 1 : 0;
+  }
+  return 0;
+}
@@ -359,9 +359,10 @@ void write<Eigen::VectorXd>(const mc_rtc::log::FlatLog & log, const std::string
 
 void mc_bin_to_flat(const std::string & in,
                     const std::string & out,
-                    const std::vector<std::string> & entriesFilter = {})
+                    const std::vector<std::string> & entriesFilter,
+                    size_t jobs)
 {
-  mc_rtc::log::FlatLog log(in);
+  auto log = utils::load(in, entriesFilter, jobs);
   auto entries = utils::entries(log, entriesFilter);
   std::ofstream ofs(out, std::ofstream::binary);
   utils::write(utils::nEntries(log, entries), ofs);
@@ -14,7 +14,10 @@
  * @param out Output path to the flatlog
  * @param entriesFilter Name of entries to convert. When empty, convert all
  * entries
+ * @param jobs Number of threads used to decode the log (0: one per hardware
+ * thread)
  */
 void mc_bin_to_flat(const std::string & in,
                     const std::string & out,
-                    const std::vector<std::string> & entriesFilter = {});
+                    const std::vector<std::string> & entriesFilter = {},
+                    size_t jobs = 1);
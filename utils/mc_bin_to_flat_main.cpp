@@ -11,25 +11,52 @@ namespace bfs = boost::filesystem;
 
 void usage(const char * bin)
 {
-  mc_rtc::log::error("Usage: {} [bin] ([flat])", bin);
+  mc_rtc::log::error("Usage: {} [--jobs N] [bin] ([flat])", bin);
 }
 
 int main(int argc, char * argv[])
 {
-  if(argc != 3 && argc != 2)
+  std::vector<std::string> args;
+  size_t jobs = 1;
+  for(int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if(arg == "--jobs" || arg == "-j")
+    {
+      if(i + 1 == argc)
+      {
+        usage(argv[0]);
+        return 1;
+      }
+      try
+      {
+        jobs = std::stoul(argv[++i]);
+      }
+      catch(const std::exception &)
+      {
+        usage(argv[0]);
+        return 1;
+      }
+    }
+    else
+    {
+      args.push_back(arg);
+    }
+  }
+  if(args.size() != 2 && args.size() != 1)
   {
     usage(argv[0]);
     return 1;
   }
-  std::string in = argv[1];
+  std::string in = args[0];
   std::string out = "";
-  if(argc == 3)
+  if(args.size() == 2)
   {
-    out = argv[2];
+    out = args[1];
   }
   else
   {
-    out = bfs::path(argv[1]).filename().replace_extension(".flat").string();
+    out = bfs::path(in).filename().replace_extension(".flat").string();
     if(out == in)
     {
       mc_rtc::log::error("Please specify a different output name");
@@ -37,6 +64,6 @@ int main(int argc, char * argv[])
     }
     mc_rtc::log::info("Output converted log to {}", out);
   }
-  mc_bin_to_flat(in, out);
+  mc_bin_to_flat(in, out, {}, jobs);
   return 0;
 }
@@ -325,9 +325,12 @@ void write_data(std::ofstream & ofs, const mc_rtc::log::FlatLog & log, const Siz
   }
 }
 
-void mc_bin_to_log(const std::string & in, const std::string & out, const std::vector<std::string> & entriesFilter)
+void mc_bin_to_log(const std::string & in,
+                   const std::string & out,
+                   const std::vector<std::string> & entriesFilter,
+                   size_t jobs)
 {
-  mc_rtc::log::FlatLog log(in);
+  auto log = utils::load(in, entriesFilter, jobs);
   std::ofstream ofs(out);
   if(!ofs.is_open())
   {
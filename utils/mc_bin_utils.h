@@ -7,6 +7,21 @@
 namespace utils
 {
 
+/** Load a log for conversion
+ *
+ * When a filter is provided, only the requested entries are decoded. Otherwise the whole log is decoded with \p jobs
+ * threads.
+ */
+inline mc_rtc::log::FlatLog load(const std::string & in, const std::vector<std::string> & entriesFilter, size_t jobs)
+{
+  mc_rtc::log::FlatLog log(in, true);
+  if(entriesFilter.empty())
+  {
+    log.decodeAll(jobs);
+  }
+  return log;
+}
+
 inline std::map<std::string, mc_rtc::log::LogType> entries(const mc_rtc::log::FlatLog & log,
                                                            const std::vector<std::string> & entriesFilter)
 {
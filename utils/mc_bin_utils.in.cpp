@@ -10,6 +10,7 @@
  */
 
 #include <mc_rtc/config.h>
+#include <mc_rtc/log/BinaryLogReader.h>
 #include <mc_rtc/log/FlatLog.h>
 #include <mc_rtc/log/Logger.h>
 #include <mc_rtc/log/iterate_binary_log.h>
@@ -412,16 +413,21 @@ int extract(int argc, char * argv[])
     return true;
   };
   std::vector<std::string> keys;
-  double final_t = 0;
+  bool reached_to = false;
   auto callback_extract_from_to = [&](const std::vector<std::string> & ks,
                                       const std::vector<mc_rtc::log::FlatLog::record> &, double t,
                                       const mc_rtc::log::copy_callback & copy, const char * data, uint64_t dataSize) {
-    final_t = t;
     if(ks.size())
     {
       keys = ks;
     }
-    if(t >= from && t <= to)
+    if(t > to)
+    {
+      // Stop reading the log
+      reached_to = true;
+      return false;
+    }
+    if(t >= from)
     {
       if(!ofs.is_open())
       {
@@ -466,13 +472,20 @@ int extract(int argc, char * argv[])
   }
   if(from != 0 || to != std::numeric_limits<double>::infinity())
   {
-    if(!mc_rtc::log::iterate_binary_log(in, mc_rtc::log::binary_log_copy_callback(callback_extract_from_to), false))
+    // Only the frames after the start time are read
+    mc_rtc::log::BinaryLogReader reader(in);
+    if(!reader.valid())
+    {
+      return 1;
+    }
+    if(reader.seek(from)
+       && !reader.iterate(mc_rtc::log::binary_log_copy_callback(callback_extract_from_to), false) && !reached_to)
     {
       return 1;
     }
     if(!ofs.is_open())
     {
-      std::cout << "Provided start time is higher than last time recorded: " << final_t << "\n";
+      std::cout << "Provided start time is higher than last time recorded\n";
     }
   }
   if(extract_keys.size())
@@ -588,6 +601,7 @@ int convert(int argc, char * argv[])
   po::variables_map vm;
   po::options_description tool("mc_bin_utils convert options");
   double dt = 0.005;
+  size_t jobs = 1;
   // clang-format off
   tool.add_options()
     ("help", "Produce this message")
@@ -595,7 +609,8 @@ int convert(int argc, char * argv[])
     ("out", po::value<std::string>(), "Output file or template")
     ("format", po::value<std::string>(), "Log format (csv|flat|bag), can be deduced from [out]")
     ("entries", po::value<std::vector<std::string>>()->multitoken(), "Name of entries to log (all if ommitted)")
-    ("dt", po::value<double>(&dt), "Log timestep (only for bag conversion)");
+    ("dt", po::value<double>(&dt), "Log timestep (only for bag conversion)")
+    ("jobs,j", po::value<size_t>(&jobs), "Number of threads used to decode the log, 0 uses all hardware threads (only for csv and flat conversion)");
   // clang-format on
   po::positional_options_description pos;
   pos.add("in", 1);
@@ -686,11 +701,11 @@ int convert(int argc, char * argv[])
 
   if(format == ".flat")
   {
-    mc_bin_to_flat(in, out_p.string(), entries);
+    mc_bin_to_flat(in, out_p.string(), entries, jobs);
   }
   else if(format == ".csv" || format == ".log")
   {
-    mc_bin_to_log(in, out_p.string(), entries);
+    mc_bin_to_log(in, out_p.string(), entries, jobs);
   }
   else if(format == ".bag")
   {